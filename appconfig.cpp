@@ -0,0 +1,147 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "appconfig.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStandardPaths>
+
+QUrl AppConfig::urlFromArgument(const QString &argument) {
+  if (argument.isEmpty()) {
+    return QUrl();
+  }
+
+  QUrl url(argument);
+  if (url.scheme().isEmpty()) {
+    url = QUrl("https://" + argument);
+  }
+  return url;
+}
+
+bool AppConfig::minimizedLoadFromString(const QString &name,
+                                        MinimizedLoad &policy) {
+  if (name == "immediate") {
+    policy = LoadImmediately;
+  } else if (name == "idle") {
+    policy = LoadWhenIdle;
+  } else if (name == "restore") {
+    policy = LoadOnRestore;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+QString AppConfig::minimizedLoadName(MinimizedLoad policy) {
+  switch (policy) {
+  case LoadWhenIdle:
+    return "idle";
+  case LoadOnRestore:
+    return "restore";
+  case LoadImmediately:
+    break;
+  }
+  return "immediate";
+}
+
+QString AppConfig::profilePath() const {
+  const QString application =
+      appName.isEmpty() ? QCoreApplication::applicationName() : appName;
+  return QStandardPaths::writableLocation(
+             QStandardPaths::GenericDataLocation) +
+         QDir::separator() + QCoreApplication::organizationName() +
+         QDir::separator() + application + QDir::separator() + "QtWebEngine" +
+         QDir::separator() + profile();
+}
+
+bool AppConfig::hasDesktopFile() const {
+  if (appId.isEmpty()) {
+    return false;
+  }
+
+  QString desktopPath =
+      QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation) +
+      "/" + appId + ".desktop";
+  return QFile::exists(desktopPath) ||
+         QFile::exists("/usr/share/applications/" + appId + ".desktop");
+}
+
+// Paths are made absolute, the receiving process may have another working
+// directory
+static QString absolutePath(const QString &path) {
+  return path.isEmpty() ? path : QFileInfo(path).absoluteFilePath();
+}
+
+QJsonObject AppConfig::toJson() const {
+  return QJsonObject{
+      {"url", url.toString()},
+      {"app-id", appId},
+      {"profile", profileName},
+      {"name", appName},
+      {"icon", absolutePath(iconPath)},
+      {"tray-icon", absolutePath(trayIconPath)},
+      {"minimized", startMinimized},
+      {"notify", notify},
+      {"readahead", readahead},
+      {"notification-limit", notificationLimit},
+      {"minimized-load", minimizedLoadName(minimizedLoad)},
+  };
+}
+
+AppConfig AppConfig::fromJson(const QJsonObject &json) {
+  AppConfig config;
+  config.url = urlFromArgument(json.value("url").toString());
+  config.appId = json.value("app-id").toString();
+  config.profileName = json.value("profile").toString();
+  config.appName = json.value("name").toString();
+  config.iconPath = json.value("icon").toString();
+  config.trayIconPath = json.value("tray-icon").toString();
+  config.startMinimized = json.value("minimized").toBool(false);
+  config.notify = json.value("notify").toBool(true);
+  config.readahead = json.value("readahead").toBool(true);
+  config.notificationLimit = json.value("notification-limit").toInt(2);
+  minimizedLoadFromString(json.value("minimized-load").toString(),
+                          config.minimizedLoad);
+  return config;
+}
+
+QList<AppConfig> AppConfig::readFile(const QString &path) {
+  QList<AppConfig> apps;
+  if (!QFile::exists(path)) {
+    qWarning() << "Host config not found:" << path;
+    return apps;
+  }
+
+  QSettings settings(path, QSettings::IniFormat);
+  const QStringList groups = settings.childGroups();
+  for (const QString &group : groups) {
+    settings.beginGroup(group);
+    AppConfig config;
+    config.url = urlFromArgument(settings.value("url").toString());
+    config.appId = settings.value("app-id").toString();
+    // Default to one profile per app, so apps in the same file stay isolated
+    config.profileName = settings.value("profile", group).toString();
+    config.appName = settings.value("name").toString();
+    config.iconPath = settings.value("icon").toString();
+    config.trayIconPath = settings.value("tray-icon").toString();
+    config.startMinimized = settings.value("minimized", false).toBool();
+    config.notify = settings.value("notify", true).toBool();
+    config.readahead = settings.value("readahead", true).toBool();
+    config.notificationLimit =
+        settings.value("notification-limit", 2).toInt();
+    const QString minimizedLoad =
+        settings.value("minimized-load", "immediate").toString();
+    if (!minimizedLoadFromString(minimizedLoad, config.minimizedLoad)) {
+      qWarning() << "Unknown minimized-load" << minimizedLoad << "for"
+                 << group;
+    }
+    settings.endGroup();
+    apps.append(config);
+  }
+  return apps;
+}
@@ -0,0 +1,74 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+// Everything that describes one web app: what the command line options set
+// for a standalone instance, or one entry of a host mode config file.
+struct AppConfig {
+  // When a --minimized app loads its start URL
+  enum MinimizedLoad {
+    LoadImmediately, // needed by apps that only deliver push notifications
+    LoadWhenIdle,    // once the CPU has settled after login
+    LoadOnRestore,   // when the window is first shown
+  };
+
+  QUrl url;
+  QString appId;
+  QString profileName;
+  QString appName;
+  QString iconPath;
+  QString trayIconPath;
+  bool startMinimized = false;
+  bool notify = true;
+  bool readahead = true;
+  // Notifications shown one by one every 2 seconds, more are summarized
+  int notificationLimit = 2;
+  MinimizedLoad minimizedLoad = LoadImmediately;
+
+  // "immediate", "idle" or "restore". Returns false for anything else.
+  static bool minimizedLoadFromString(const QString &name,
+                                      MinimizedLoad &policy);
+  static QString minimizedLoadName(MinimizedLoad policy);
+
+  // Parses a --url value. If no scheme is provided, default to https.
+  static QUrl urlFromArgument(const QString &argument);
+
+  QString profile() const {
+    return profileName.isEmpty() ? QStringLiteral("default") : profileName;
+  }
+
+  // Where the profile keeps its data. This is the AppLocalDataLocation of an
+  // instance whose application name is the app name, so an app finds the same
+  // cookies and settings whether it runs standalone or in a host.
+  QString profilePath() const;
+
+  // True if a desktop entry for appId is installed
+  bool hasDesktopFile() const;
+
+  // Used to pass an app to a running host
+  QJsonObject toJson() const;
+  static AppConfig fromJson(const QJsonObject &json);
+
+  // Reads a host mode config file. Each INI group is one app, with keys named
+  // after the command line options, e.g.
+  //
+  //   [discord]
+  //   url=https://discord.com/app
+  //   profile=chat
+  //   name=Discord
+  //   icon=/path/to/discord.png
+  //   minimized=true
+  //   minimized-load=idle
+  //   readahead=false
+  //   notification-limit=5
+  static QList<AppConfig> readFile(const QString &path);
+};
+
+#endif // APPCONFIG_H
@@ -0,0 +1,113 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "apphost.h"
+
+#include "startuptrace.h"
+#include "webapp.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QStandardPaths>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+
+AppHost::AppHost(Mode mode, QObject *parent)
+    : QObject(parent), m_mode(mode),
+      m_control(mode == Launcher ? "webappcontainer-launcher"
+                                 : "webappcontainer-host") {
+  connect(&m_control, &SingleInstance::requestReceived, this,
+          &AppHost::handleRequest);
+}
+
+AppHost::~AppHost() { qDeleteAll(m_apps); }
+
+QString AppHost::defaultConfigPath() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) +
+         "/apps.ini";
+}
+
+bool AppHost::listen() { return m_control.listen(); }
+
+bool AppHost::forward(const QList<AppConfig> &apps, int timeoutMs) {
+  QJsonArray list;
+  for (const AppConfig &config : apps) {
+    list.append(config.toJson());
+  }
+  return m_control.send(QJsonObject{{"command", "open"}, {"apps", list}},
+                        timeoutMs);
+}
+
+void AppHost::prewarm() {
+  QElapsedTimer timer;
+  timer.start();
+
+  // Loading a blank page in the default profile brings up the browser, GPU
+  // and network service processes. They stay up for the apps' own profiles
+  // once the page is gone.
+  QWebEnginePage *page = new QWebEnginePage(QWebEngineProfile::defaultProfile(),
+                                            this);
+  connect(page, &QWebEnginePage::loadFinished, this, [page, timer]() {
+    qDebug() << "Launcher ready in" << timer.elapsed() << "ms";
+    StartupTrace::mark("launcherReady");
+    StartupTrace::write();
+    page->deleteLater();
+  });
+  page->load(QUrl("about:blank"));
+}
+
+void AppHost::handleRequest(const QJsonObject &request) {
+  if (request.value("command").toString() != "open") {
+    return;
+  }
+
+  const QJsonArray list = request.value("apps").toArray();
+  for (const QJsonValue &value : list) {
+    open(AppConfig::fromJson(value.toObject()));
+  }
+}
+
+void AppHost::open(const AppConfig &config) {
+  const QString profilePath = config.profilePath();
+  for (WebApp *app : std::as_const(m_apps)) {
+    if (app->config().profilePath() == profilePath) {
+      app->activate(config.url, !config.startMinimized);
+      return;
+    }
+  }
+
+  WebApp *app = new WebApp(config);
+  if (!app->claimProfile()) {
+    // Already running standalone, leave it there
+    qDebug() << "Profile" << config.profile()
+             << "is running in another process, forwarding";
+    app->forwardToRunningInstance();
+    delete app;
+    return;
+  }
+
+  qDebug() << "Hosting" << (config.appName.isEmpty() ? config.profile()
+                                                      : config.appName);
+  m_apps.append(app);
+  // Queued, the window is still handling its quit action
+  connect(
+      app, &WebApp::quitRequested, this, [this, app]() { close(app); },
+      Qt::QueuedConnection);
+  app->start();
+  emit opened(app);
+}
+
+void AppHost::close(WebApp *app) {
+  if (!m_apps.removeOne(app)) {
+    return;
+  }
+  delete app;
+
+  // Other apps may still be hidden in the tray, so the host only quits with
+  // its last app. A launcher stays for the next launch.
+  if (m_apps.isEmpty() && m_mode == Host) {
+    QCoreApplication::quit();
+  }
+}
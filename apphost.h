@@ -0,0 +1,64 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef APPHOST_H
+#define APPHOST_H
+
+#include <QList>
+#include <QObject>
+
+#include "appconfig.h"
+#include "singleinstance.h"
+
+class WebApp;
+
+// Runs several web apps in one process (--host). The apps share QtWebEngine's
+// browser, GPU and network service processes, but each has its own profile,
+// window and tray icon, so their storage stays as isolated as it is with one
+// process per app. Further apps can be added while the host runs by launching
+// with --host again.
+//
+// A launcher (--launcher) is a host that starts without apps and stays
+// resident. It initializes QtWebEngine up front, so a normal launch that is
+// handed to it only has to create a profile and a window.
+class AppHost : public QObject {
+  Q_OBJECT
+
+public:
+  enum Mode { Host, Launcher };
+
+  explicit AppHost(Mode mode = Host, QObject *parent = nullptr);
+  ~AppHost();
+
+  static QString defaultConfigPath();
+
+  // Becomes the host. Returns false if another process already is.
+  bool listen();
+
+  // Hands apps to the running host. timeoutMs bounds each step of the
+  // exchange.
+  bool forward(const QList<AppConfig> &apps, int timeoutMs = 5000);
+
+  // Starts QtWebEngine's browser, GPU and network service processes before
+  // the first app needs them
+  void prewarm();
+
+  // Starts an app, or brings it to the front if its profile is already open
+  void open(const AppConfig &config);
+
+  const QList<WebApp *> &apps() const { return m_apps; }
+
+signals:
+  // A new app was started, its window exists and its page is loading
+  void opened(WebApp *app);
+
+private:
+  void handleRequest(const QJsonObject &request);
+  void close(WebApp *app);
+
+  Mode m_mode;
+  SingleInstance m_control;
+  QList<WebApp *> m_apps;
+};
+
+#endif // APPHOST_H
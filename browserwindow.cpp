@@ -4,18 +4,22 @@
 #include "browserwindow.h"
 #include "./ui_browserwindow.h"
 
+#include "downloadmanagerwidget.h"
+#include "iconcache.h"
+#include "notificationcoalescer.h"
+#include "pageplaceholder.h"
+#include "settingsstore.h"
+#include "startuptrace.h"
 #include "webpage.h"
 
 #include <QCloseEvent>
 #include <QFile>
 #include <QFileInfo>
 #include <QIcon>
-#include <QImageReader>
 #include <QNetworkCookie>
-#include <QPainter>
-#include <QSettings>
 #include <QStyle>
 #include <QWebEngineCookieStore>
+#include <QWebEngineDownloadRequest>
 #include <QWebEngineNotification>
 #include <QWindow>
 
@@ -23,34 +27,124 @@ BrowserWindow::BrowserWindow(QWebEngineProfile *profile, const QString appName,
                              const QString iconPath, const QString trayIconPath,
                              bool notify, QWidget *parent)
     : QDialog(parent), ui(new Ui::BrowserWindow), m_profile(profile),
-      m_webView(new WebView(profile, this)), m_notify(notify),
-      m_hideOnMinimize(false), m_hideOnClose(true) {
+      m_webView(new WebView(profile, this)),
+      m_settings(SettingsStore::forProfile(profile->persistentStoragePath())),
+      m_notify(notify), m_hideOnMinimize(false), m_hideOnClose(true),
+      m_appName(appName), m_trayIconPath(trayIconPath) {
   ui->setupUi(this);
 
+  // Only what the first frame needs is set up here, so the first URL can be
+  // set as early as possible. The tray icon and the download manager are
+  // created once the window has been painted, or when first used.
+  ui->webViewLayout->addWidget(m_webView);
+
+  // Shows the last frame of the previous session until the page renders
+  m_placeholder = new PagePlaceholder(
+      m_webView, m_profile->persistentStoragePath() + "/snapshot.jpg");
+
   loadLayout();
   loadSettings();
 
+  // Geometry is saved as it changes, so a killed process keeps it too
+  m_saveLayoutTimer.setSingleShot(true);
+  m_saveLayoutTimer.setInterval(500);
+  connect(&m_saveLayoutTimer, &QTimer::timeout, this,
+          &BrowserWindow::saveLayout);
+
   // Set the Window Title
   if (!appName.isEmpty()) {
     setWindowTitle(appName);
   }
 
-  if (isValidImage(iconPath)) {
-    setWindowIcon(QIcon(iconPath));
+  const QIcon icon = IconCache::icon(iconPath);
+  if (!icon.isNull()) {
+    setWindowIcon(icon);
+    m_trayIconSource = iconPath;
   } else {
     setWindowIcon(style()->standardIcon(QStyle::SP_TitleBarMenuButton));
   }
 
+  // Notifications happen at the Profile level, not the Page level
+  m_notifications = new NotificationCoalescer(2, 2000, this);
+  connect(m_notifications, &NotificationCoalescer::delivered, this,
+          [this](QObject *notification) {
+            handleWebNotification(
+                qobject_cast<QWebEngineNotification *>(notification));
+          });
+  connect(m_notifications, &NotificationCoalescer::summarized, this,
+          [this](int count, QObject *latest) {
+            handleNotificationSummary(
+                count, qobject_cast<QWebEngineNotification *>(latest));
+          });
+  m_profile->setNotificationPresenter(
+      [this](std::unique_ptr<QWebEngineNotification> notification) {
+        m_notifications->add(std::move(notification));
+      });
+
+  QWebEngineCookieStore *store = m_profile->cookieStore();
+  // This tells the engine: "Yes, allow every cookie request"
+  store->setCookieFilter(
+      [](const QWebEngineCookieStore::FilterRequest &request) { return true; });
+  // Force the profile to 'touch' the storage
+  store->loadAllCookies();
+
+  QObject::connect(m_profile, &QWebEngineProfile::downloadRequested, this,
+                   [this](QWebEngineDownloadRequest *download) {
+                     downloadManagerWidget().downloadRequested(download);
+                   });
+}
+
+BrowserWindow::~BrowserWindow() {
+  if (m_trayIcon) {
+    m_trayIcon->hide();
+    disconnect(m_trayIcon, nullptr, this, nullptr);
+  }
+
+  if (m_profile) {
+    m_profile->setNotificationPresenter(nullptr);
+    disconnect(m_profile, nullptr, this, nullptr);
+  }
+
+  // The notifications belong to the profile's pages
+  delete m_notifications;
+  m_notifications = nullptr;
+
+  if (m_webView) {
+    delete m_webView;
+    m_webView = nullptr;
+  }
+
+  QCoreApplication::processEvents();
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+  delete m_downloadManagerWidget;
+  delete ui;
+}
+
+DownloadManagerWidget &BrowserWindow::downloadManagerWidget() {
+  if (!m_downloadManagerWidget) {
+    m_downloadManagerWidget = new DownloadManagerWidget();
+
+    // Quit application if the download manager is the only remaining window
+    m_downloadManagerWidget->setAttribute(Qt::WA_QuitOnClose, false);
+  }
+  return *m_downloadManagerWidget;
+}
+
+void BrowserWindow::createTrayIcon() {
+  if (m_trayIcon) {
+    return;
+  }
+  StartupTrace::Scope trace("createTrayIcon");
+
   // Determine the base tray icon
-  if (isValidImage(trayIconPath)) {
-    m_baseIcon = QIcon(trayIconPath);
+  m_baseIcon = IconCache::icon(m_trayIconPath);
+  if (!m_baseIcon.isNull()) {
+    m_trayIconSource = m_trayIconPath;
   } else {
     m_baseIcon = this->windowIcon();
   }
 
-  // Create the notification variant
-  m_notificationIcon = createNotificationIcon(m_baseIcon);
-
   // Create Actions for the tray icon Menu
   restoreAction = new QAction("Restore", this);
   connect(restoreAction, &QAction::triggered, this, &QWidget::showNormal);
@@ -74,7 +168,7 @@ BrowserWindow::BrowserWindow(QWebEngineProfile *profile, const QString appName,
   quitAction = new QAction("Exit", this);
   connect(quitAction, &QAction::triggered, this, [this]() {
     isQuitting = true; // Tell the closeEvent we actually want to quit
-    qApp->quit();
+    emit quitRequested();
   });
 
   // Create the tray icon Context Menu
@@ -89,13 +183,13 @@ BrowserWindow::BrowserWindow(QWebEngineProfile *profile, const QString appName,
   // Initialize Tray Icon
   m_trayIcon = new QSystemTrayIcon(this);
   m_trayIcon->setContextMenu(m_trayMenu);
-  if (appName.isEmpty()) {
+  if (m_appName.isEmpty()) {
     m_trayIcon->setToolTip("Web App Container");
   } else {
-    m_trayIcon->setToolTip(appName);
+    m_trayIcon->setToolTip(m_appName);
   }
 
-  m_trayIcon->setIcon(m_baseIcon);
+  updateTrayIcon();
   m_trayIcon->show();
 
   // Handle double-click on tray icon
@@ -132,130 +226,45 @@ BrowserWindow::BrowserWindow(QWebEngineProfile *profile, const QString appName,
   connect(m_trayIcon, &QSystemTrayIcon::messageClicked, this,
           &BrowserWindow::onNotificationClicked);
 
-  // Notifications happen at the Profile level, not the Page level
-  m_profile->setNotificationPresenter(
-      [&](std::unique_ptr<QWebEngineNotification> notification) {
-        BrowserWindow::handleWebNotification(notification.get());
-      });
-
-  // Quit application if the download manager is the only remaining window
-  m_downloadManagerWidget.setAttribute(Qt::WA_QuitOnClose, false);
-
-  QWebEngineCookieStore *store = m_profile->cookieStore();
-  // This tells the engine: "Yes, allow every cookie request"
-  store->setCookieFilter(
-      [](const QWebEngineCookieStore::FilterRequest &request) { return true; });
-  // Force the profile to 'touch' the storage
-  store->loadAllCookies();
-
-  QObject::connect(m_profile, &QWebEngineProfile::downloadRequested,
-                   &m_downloadManagerWidget,
-                   &DownloadManagerWidget::downloadRequested);
-
-  // Add to layout
-  ui->webViewLayout->addWidget(m_webView);
-}
-
-BrowserWindow::~BrowserWindow() {
-  if (m_trayIcon) {
-    m_trayIcon->hide();
-    disconnect(m_trayIcon, nullptr, this, nullptr);
-  }
-
-  if (m_profile) {
-    m_profile->setNotificationPresenter(nullptr);
-    disconnect(m_profile, nullptr, this, nullptr);
-    disconnect(m_profile, nullptr, &m_downloadManagerWidget, nullptr);
-  }
-
-  m_currentNotification = nullptr;
-
-  if (m_webView) {
-    delete m_webView;
-    m_webView = nullptr;
-  }
-
-  QCoreApplication::processEvents();
-  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
-
-  delete ui;
 }
 
 void BrowserWindow::loadLayout() {
-  QSettings settings(m_profile->persistentStoragePath() + "/settings.ini",
-                     QSettings::IniFormat);
-
-  settings.beginGroup("BrowserWindow");
-  QByteArray geometry = settings.value("geometry").toByteArray();
+  QByteArray geometry =
+      m_settings->value("BrowserWindow/geometry").toByteArray();
   if (!geometry.isEmpty()) {
     restoreGeometry(geometry);
   }
-  settings.endGroup();
 }
 
 void BrowserWindow::saveLayout() {
-  QSettings settings(m_profile->persistentStoragePath() + "/settings.ini",
-                     QSettings::IniFormat);
-
-  settings.beginGroup("BrowserWindow");
-  settings.setValue("geometry", saveGeometry());
-  settings.endGroup();
-
-  settings.sync();
+  m_settings->setValue("BrowserWindow/geometry", saveGeometry());
 }
 
 void BrowserWindow::loadSettings() {
-  QSettings settings(m_profile->persistentStoragePath() + "/settings.ini",
-                     QSettings::IniFormat);
-
-  settings.beginGroup("Behavior");
-  m_hideOnMinimize = settings.value("hideOnMinimize", false).toBool();
-  m_hideOnClose = settings.value("hideOnClose", true).toBool();
-  settings.endGroup();
+  m_hideOnMinimize =
+      m_settings->value("Behavior/hideOnMinimize", false).toBool();
+  m_hideOnClose = m_settings->value("Behavior/hideOnClose", true).toBool();
 }
 
 void BrowserWindow::saveSettings() {
-  QSettings settings(m_profile->persistentStoragePath() + "/settings.ini",
-                     QSettings::IniFormat);
-
-  settings.beginGroup("Behavior");
-  settings.setValue("hideOnMinimize", m_hideOnMinimize);
-  settings.setValue("hideOnClose", m_hideOnClose);
-  settings.endGroup();
-
-  settings.sync();
-}
-
-QIcon BrowserWindow::createNotificationIcon(const QIcon &baseIcon) {
-  // Get the largest available size or use a default
-  QList<QSize> sizes = baseIcon.availableSizes();
-  QSize iconSize = sizes.isEmpty() ? QSize(64, 64) : sizes.last();
-
-  QPixmap pixmap = baseIcon.pixmap(iconSize);
-  QPainter painter(&pixmap);
-  painter.setRenderHint(QPainter::Antialiasing);
-
-  // Draw red dot in top-right corner
-  int dotSize = iconSize.width() / 3;
-  int x = iconSize.width() - dotSize - 1;
-  int y = 1;
-
-  // Draw white border
-  painter.setBrush(Qt::white);
-  painter.setPen(Qt::NoPen);
-  painter.drawEllipse(x - 1, y - 1, dotSize + 2, dotSize + 2);
-
-  // Draw red dot
-  painter.setBrush(QColor(255, 59, 48)); // Apple-style red
-  painter.drawEllipse(x, y, dotSize, dotSize);
-
-  painter.end();
-
-  return QIcon(pixmap);
+  m_settings->setValue("Behavior/hideOnMinimize", m_hideOnMinimize);
+  m_settings->setValue("Behavior/hideOnClose", m_hideOnClose);
 }
 
 void BrowserWindow::updateTrayIcon() {
+  if (!m_trayIcon) {
+    return;
+  }
+
   if (m_hasNotification) {
+    // Only rendered once the first notification arrives, and read from the
+    // icon cache when the base icon comes from a file
+    if (m_notificationIcon.isNull()) {
+      m_notificationIcon =
+          m_trayIconSource.isEmpty()
+              ? IconCache::decorate(m_baseIcon, IconCache::NotificationDot)
+              : IconCache::icon(m_trayIconSource, IconCache::NotificationDot);
+    }
     m_trayIcon->setIcon(m_notificationIcon);
   } else {
     m_trayIcon->setIcon(m_baseIcon);
@@ -269,22 +278,6 @@ void BrowserWindow::clearNotificationIndicator() {
   }
 }
 
-bool BrowserWindow::isValidImage(const QString &path) {
-  if (path.isEmpty() || !QFileInfo::exists(path)) {
-    return false;
-  }
-
-  QImageReader reader(path);
-  // This checks the file header to see if Qt can actually decode it
-  if (reader.canRead()) {
-    return true;
-  }
-
-  qWarning() << "Invalid or unsupported image file:" << path
-             << "Error:" << reader.errorString();
-  return false;
-}
-
 WebView *BrowserWindow::webView() const { return m_webView; }
 
 void BrowserWindow::closeEvent(QCloseEvent *event) {
@@ -292,6 +285,8 @@ void BrowserWindow::closeEvent(QCloseEvent *event) {
     saveLayout();
     event->accept();
   } else if (m_hideOnClose) {
+    // The tray icon is the only way back to a hidden window
+    createTrayIcon();
     this->hide();
     event->ignore();
 
@@ -305,42 +300,51 @@ void BrowserWindow::closeEvent(QCloseEvent *event) {
     isQuitting = true;
     saveLayout();
     event->accept();
-    qApp->quit();
+    emit quitRequested();
   }
 }
 
+void BrowserWindow::setNotificationLimit(int limit) {
+  m_notifications->setLimit(limit);
+}
+
 void BrowserWindow::handleWebNotification(
     QWebEngineNotification *notification) {
+  if (!notification) {
+    return;
+  }
+  showNotificationMessage(notification->title(), notification->message(),
+                          notification->icon());
+
+  // Tell the page its notification was shown
+  notification->show();
+}
 
-  // Store reference to current notification for click handling
-  m_currentNotification = notification;
+void BrowserWindow::handleNotificationSummary(
+    int count, QWebEngineNotification *latest) {
+  if (!latest) {
+    return;
+  }
+  const QString title =
+      m_appName.isEmpty() ? latest->origin().host() : m_appName;
+  showNotificationMessage(title, tr("%1 new messages").arg(count),
+                          latest->icon());
+  latest->show();
+}
 
-  // Connect to notification signals for proper lifecycle management
-  connect(notification, &QWebEngineNotification::closed, this,
-          [this]() { m_currentNotification = nullptr; });
+void BrowserWindow::showNotificationMessage(const QString &title,
+                                            const QString &message,
+                                            const QImage &image) {
+  createTrayIcon();
 
   // Show system tray notification with icon if available
   QIcon notificationIcon;
-  if (!notification->icon().isNull()) {
-    notificationIcon = QIcon(QPixmap::fromImage(notification->icon()));
+  if (!image.isNull()) {
+    notificationIcon = QIcon(QPixmap::fromImage(image));
   } else {
     notificationIcon = m_trayIcon->icon();
   }
-
-  m_trayIcon->showMessage(notification->title(), notification->message(),
-                          notificationIcon);
-
-  // Show the native notification through Qt WebEngine
-  notification->show();
-
-  // Log notification for debugging
-  qDebug() << "Push Notification Received:";
-  qDebug() << "  Title:" << notification->title();
-  qDebug() << "  Message:" << notification->message();
-  qDebug() << "  Origin:" << notification->origin().toString();
-  qDebug() << "  Tag:" << notification->tag();
-  qDebug() << "  Language:" << notification->language();
-  qDebug() << "  Direction:" << notification->direction();
+  m_trayIcon->showMessage(title, message, notificationIcon);
 
   // Only show indicator if window doesn't have focus
   if (!isActiveWindow()) {
@@ -351,16 +355,33 @@ void BrowserWindow::handleWebNotification(
 
 void BrowserWindow::onNotificationClicked() {
   // Handle notification click - restore window and trigger notification click
-  if (m_currentNotification) {
+  std::unique_ptr<QObject> current = m_notifications->takeCurrent();
+  if (auto *notification =
+          qobject_cast<QWebEngineNotification *>(current.get())) {
     // Tell the web page that the notification was clicked
-    m_currentNotification->click();
+    notification->click();
 
     // Close the notification
-    m_currentNotification->close();
-    m_currentNotification = nullptr;
+    notification->close();
   }
 
-  // Restore and focus the window
+  restoreWindow();
+
+  // Clear the notification indicator
+  clearNotificationIndicator();
+}
+
+void BrowserWindow::activate(const QUrl &url, bool bringToFront) {
+  if (url.isValid()) {
+    m_webView->setUrl(url);
+  }
+  if (bringToFront) {
+    restoreWindow();
+  }
+}
+
+// Restore and focus the window
+void BrowserWindow::restoreWindow() {
   if (isMinimized()) {
     showNormal();
   } else if (!isVisible()) {
@@ -375,9 +396,6 @@ void BrowserWindow::onNotificationClicked() {
     win->requestActivate();
   }
 #endif
-
-  // Clear the notification indicator
-  clearNotificationIndicator();
 }
 
 void BrowserWindow::changeEvent(QEvent *event) {
@@ -408,6 +426,22 @@ void BrowserWindow::changeEvent(QEvent *event) {
 bool BrowserWindow::event(QEvent *event) {
   if (event->type() == QEvent::WindowActivate) {
     clearNotificationIndicator();
+  } else if (event->type() == QEvent::Paint && !m_trayIcon &&
+             !m_trayIconScheduled) {
+    // Let the first frame go out before creating the tray icon
+    m_trayIconScheduled = true;
+    QTimer::singleShot(0, this, &BrowserWindow::createTrayIcon);
+  } else if ((event->type() == QEvent::Move ||
+              event->type() == QEvent::Resize) &&
+             isVisible()) {
+    m_saveLayoutTimer.start();
   }
   return QDialog::event(event);
 }
+
+void BrowserWindow::setVisible(bool visible) {
+  if (!visible && isVisible() && m_placeholder) {
+    m_placeholder->save();
+  }
+  QDialog::setVisible(visible);
+}
@@ -12,9 +12,13 @@
 #include <QTimer>
 #include <QWebEngineProfile>
 
-#include "downloadmanagerwidget.h"
 #include "webview.h"
 
+class DownloadManagerWidget;
+class NotificationCoalescer;
+class PagePlaceholder;
+class SettingsStore;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class BrowserWindow;
@@ -31,41 +35,70 @@ public:
   ~BrowserWindow();
 
   WebView *webView() const;
-  DownloadManagerWidget &downloadManagerWidget() {
-    return m_downloadManagerWidget;
-  }
-  bool isValidImage(const QString &path);
+  // Created on the first download
+  DownloadManagerWidget &downloadManagerWidget();
+
+  // Handles a launch forwarded from another process: opens url if it is
+  // valid and brings the window to the front if requested
+  void activate(const QUrl &url, bool bringToFront);
+
+  // Normally created after the window is first painted. A window that starts
+  // hidden needs it right away.
+  void createTrayIcon();
+
+  // Every way of hiding the window ends here, while it is still visible, so
+  // this is where the page snapshot is taken
+  void setVisible(bool visible) override;
+
+  // Notifications delivered one by one every 2 seconds, more are summarized
+  void setNotificationLimit(int limit);
+
+signals:
+  // The user asked to exit, from the tray menu or by closing the window with
+  // close to tray turned off
+  void quitRequested();
 
 private:
   Ui::BrowserWindow *ui;
-  QSystemTrayIcon *m_trayIcon;
-  QMenu *m_trayMenu;
-  QAction *hideOnMinimizeAction;
-  QAction *hideOnCloseAction;
-  QAction *quitAction;
-  QAction *restoreAction;
+  QSystemTrayIcon *m_trayIcon = nullptr;
+  QMenu *m_trayMenu = nullptr;
+  QAction *hideOnMinimizeAction = nullptr;
+  QAction *hideOnCloseAction = nullptr;
+  QAction *quitAction = nullptr;
+  QAction *restoreAction = nullptr;
   WebView *m_webView;
-  DownloadManagerWidget m_downloadManagerWidget;
+  DownloadManagerWidget *m_downloadManagerWidget = nullptr;
+  PagePlaceholder *m_placeholder = nullptr;
   QWebEngineProfile *m_profile;
+  SettingsStore *m_settings;
   bool m_notify;
   bool m_hideOnMinimize;
   bool m_hideOnClose;
-  bool m_hasNotification;
+  bool m_hasNotification = false;
+  bool m_trayIconScheduled = false;
+  QTimer m_saveLayoutTimer;
+  QString m_appName;
+  QString m_trayIconPath;
+  // The file the tray icon was decoded from, empty for the style's icon
+  QString m_trayIconSource;
   QIcon m_baseIcon;
   QIcon m_notificationIcon;
-  QWebEngineNotification *m_currentNotification = nullptr;
+  NotificationCoalescer *m_notifications = nullptr;
 
   void loadLayout();
   void saveLayout();
   void loadSettings();
   void saveSettings();
   void updateTrayIcon();
-  QIcon createNotificationIcon(const QIcon &baseIcon);
   void clearNotificationIndicator();
+  void restoreWindow();
+  void showNotificationMessage(const QString &title, const QString &message,
+                               const QImage &image);
   bool isQuitting = false;
 
 private slots:
   void handleWebNotification(QWebEngineNotification *notification);
+  void handleNotificationSummary(int count, QWebEngineNotification *latest);
   void onNotificationClicked();
 
 protected:
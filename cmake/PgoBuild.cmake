@@ -0,0 +1,30 @@
+# Copyright (C) 2026 Joseph Crowell.
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Builds a profile-guided release in one go:
+#   cmake -DBUILD_DIR=build-pgo -P cmake/PgoBuild.cmake
+# Both passes use the same build directory, GCC finds profiles by object path.
+
+if(NOT BUILD_DIR)
+    set(BUILD_DIR "${CMAKE_CURRENT_LIST_DIR}/../build-pgo")
+endif()
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+
+function(run)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+    if(result)
+        message(FATAL_ERROR "Failed: ${ARGN}")
+    endif()
+endfunction()
+
+message(STATUS "Building the instrumented binary...")
+run(${CMAKE_COMMAND} -S "${SOURCE_DIR}" -B "${BUILD_DIR}"
+    -DCMAKE_BUILD_TYPE=Release -DPGO=GENERATE)
+run(${CMAKE_COMMAND} --build "${BUILD_DIR}" --parallel)
+
+message(STATUS "Running the training workload...")
+run(${CMAKE_COMMAND} --build "${BUILD_DIR}" --target pgo-train)
+
+message(STATUS "Rebuilding with the recorded profile...")
+run(${CMAKE_COMMAND} -S "${SOURCE_DIR}" -B "${BUILD_DIR}" -DPGO=USE)
+run(${CMAKE_COMMAND} --build "${BUILD_DIR}" --parallel)
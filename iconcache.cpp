@@ -0,0 +1,268 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "iconcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QHash>
+#include <QImageReader>
+#include <QPainter>
+#include <QPixmap>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QSvgRenderer>
+#include <QThreadPool>
+
+namespace {
+
+// "WAIC", bumped with the version whenever the layout changes
+constexpr quint32 cacheMagic = 0x57414943;
+constexpr quint32 cacheVersion = 1;
+constexpr QImage::Format cacheFormat = QImage::Format_ARGB32_Premultiplied;
+
+// Icons already built by this process, by path and decoration
+QHash<QString, QIcon> s_icons;
+
+} // namespace
+
+QList<int> IconCache::iconSizes() {
+  // Tray (16-24), title bar and task bar (32-48) and switcher (64) sizes
+  return {16, 22, 24, 32, 48, 64};
+}
+
+void IconCache::clearMemoryCache() { s_icons.clear(); }
+
+QString IconCache::cacheDirectory() {
+  return QStandardPaths::writableLocation(
+             QStandardPaths::GenericCacheLocation) +
+         "/webappcontainer/icons";
+}
+
+QIcon IconCache::icon(const QString &path, Decoration decoration) {
+  if (path.isEmpty()) {
+    return QIcon();
+  }
+
+  const QString key = QString::number(decoration) + ':' + path;
+  const auto it = s_icons.constFind(key);
+  if (it != s_icons.constEnd()) {
+    return it.value();
+  }
+
+  const QFileInfo info(path);
+  if (!info.isFile()) {
+    return QIcon();
+  }
+
+  Source source;
+  source.path = info.absoluteFilePath();
+  source.modified = info.lastModified().toMSecsSinceEpoch();
+  source.size = info.size();
+  source.devicePixelRatio = qApp->devicePixelRatio();
+  source.decoration = decoration;
+
+  QList<QImage> images = readCache(source);
+  if (images.isEmpty()) {
+    images = rasterize(source);
+    if (images.isEmpty()) {
+      return QIcon();
+    }
+    writeCache(source, images);
+  }
+
+  const QIcon icon = toIcon(images);
+  s_icons.insert(key, icon);
+  return icon;
+}
+
+QIcon IconCache::decorate(const QIcon &icon, Decoration decoration) {
+  if (decoration == Plain || icon.isNull()) {
+    return icon;
+  }
+
+  const qreal ratio = qApp->devicePixelRatio();
+  QList<QImage> images;
+  const QList<int> sizes = iconSizes();
+  for (int size : sizes) {
+    QImage image = icon.pixmap(QSize(size, size), ratio)
+                       .toImage()
+                       .convertToFormat(cacheFormat);
+    drawNotificationDot(image);
+    images.append(image);
+  }
+  return toIcon(images);
+}
+
+QString IconCache::cachePath(const Source &source) {
+  // One file per source and decoration, replaced when the source changes
+  const QByteArray hash = QCryptographicHash::hash(
+      (QString::number(source.decoration) + ':' + source.path).toUtf8(),
+      QCryptographicHash::Sha1);
+  return cacheDirectory() + '/' + QString::fromLatin1(hash.toHex().left(16)) +
+         ".icon";
+}
+
+QList<QImage> IconCache::readCache(const Source &source) {
+  QFile file(cachePath(source));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return {};
+  }
+
+  QDataStream in(&file);
+  quint32 magic = 0, version = 0, count = 0;
+  qint64 modified = 0, size = 0;
+  double ratio = 0;
+  in >> magic >> version >> modified >> size >> ratio >> count;
+  if (in.status() != QDataStream::Ok || magic != cacheMagic ||
+      version != cacheVersion || modified != source.modified ||
+      size != source.size || ratio != source.devicePixelRatio ||
+      count > 16) {
+    return {};
+  }
+
+  // The pixels are stored as they are in memory, there is nothing to decode
+  QList<QImage> images;
+  for (quint32 i = 0; i < count; ++i) {
+    quint32 width = 0, height = 0;
+    in >> width >> height;
+    if (in.status() != QDataStream::Ok || width == 0 || height == 0 ||
+        width > 1024 || height > 1024) {
+      return {};
+    }
+    QImage image(int(width), int(height), cacheFormat);
+    const int bytes = int(image.sizeInBytes());
+    if (in.readRawData(reinterpret_cast<char *>(image.bits()), bytes) !=
+        bytes) {
+      return {};
+    }
+    image.setDevicePixelRatio(source.devicePixelRatio);
+    images.append(image);
+  }
+  return images;
+}
+
+void IconCache::writeCache(const Source &source,
+                           const QList<QImage> &images) {
+  const QString path = cachePath(source);
+  QThreadPool::globalInstance()->start([source, images, path]() {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+      return;
+    }
+    QDataStream out(&file);
+    out << cacheMagic << cacheVersion << source.modified << source.size
+        << double(source.devicePixelRatio) << quint32(images.size());
+    for (const QImage &image : images) {
+      out << quint32(image.width()) << quint32(image.height());
+      out.writeRawData(reinterpret_cast<const char *>(image.constBits()),
+                       int(image.sizeInBytes()));
+    }
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+      qWarning() << "Could not cache icon" << source.path << "in" << path;
+    }
+  });
+}
+
+QList<QImage> IconCache::rasterize(const Source &source) {
+  QImageReader reader(source.path);
+  // This checks the file header to see if Qt can actually decode it
+  if (!reader.canRead()) {
+    qWarning() << "Invalid or unsupported image file:" << source.path
+               << "Error:" << reader.errorString();
+    return {};
+  }
+
+  const QByteArray format = reader.format();
+  const bool vector = format == "svg" || format == "svgz";
+
+  // Vector icons are parsed once and rendered at every size, raster icons
+  // are decoded once and scaled down from the original
+  QSvgRenderer renderer;
+  QImage original;
+  if (vector) {
+    if (!renderer.load(source.path)) {
+      qWarning() << "Invalid SVG image file:" << source.path;
+      return {};
+    }
+  } else {
+    original = reader.read();
+    if (original.isNull()) {
+      qWarning() << "Invalid or unsupported image file:" << source.path
+                 << "Error:" << reader.errorString();
+      return {};
+    }
+  }
+
+  const QSize naturalSize =
+      vector ? renderer.defaultSize() : original.size();
+  QList<QImage> images;
+  const QList<int> sizes = iconSizes();
+  for (int size : sizes) {
+    const int pixels = qRound(size * source.devicePixelRatio);
+    const QSize target =
+        naturalSize.isEmpty()
+            ? QSize(pixels, pixels)
+            : naturalSize.scaled(pixels, pixels, Qt::KeepAspectRatio);
+
+    QImage image;
+    if (vector) {
+      image = QImage(target, cacheFormat);
+      image.fill(Qt::transparent);
+      QPainter painter(&image);
+      renderer.render(&painter);
+    } else {
+      image = original
+                  .scaled(target, Qt::KeepAspectRatio,
+                          Qt::SmoothTransformation)
+                  .convertToFormat(cacheFormat);
+    }
+
+    if (source.decoration == NotificationDot) {
+      drawNotificationDot(image);
+    }
+    image.setDevicePixelRatio(source.devicePixelRatio);
+    images.append(image);
+  }
+  return images;
+}
+
+void IconCache::drawNotificationDot(QImage &image) {
+  // Paint in device pixels, the dot scales with the raster
+  const qreal ratio = image.devicePixelRatio();
+  image.setDevicePixelRatio(1);
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+
+  // Draw red dot in top-right corner
+  const int dotSize = image.width() / 3;
+  const int x = image.width() - dotSize - 1;
+  const int y = 1;
+
+  // Draw white border
+  painter.setBrush(Qt::white);
+  painter.setPen(Qt::NoPen);
+  painter.drawEllipse(x - 1, y - 1, dotSize + 2, dotSize + 2);
+
+  // Draw red dot
+  painter.setBrush(QColor(255, 59, 48)); // Apple-style red
+  painter.drawEllipse(x, y, dotSize, dotSize);
+
+  painter.end();
+  image.setDevicePixelRatio(ratio);
+}
+
+QIcon IconCache::toIcon(const QList<QImage> &images) {
+  QIcon icon;
+  for (const QImage &image : images) {
+    icon.addPixmap(QPixmap::fromImage(image));
+  }
+  return icon;
+}
@@ -0,0 +1,60 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QIcon>
+#include <QImage>
+#include <QList>
+#include <QString>
+
+// Decodes app and tray icons once per process and once per file version.
+// Every source is rasterized at the sizes windows, task bars and trays ask
+// for, multiplied by the screen's device pixel ratio; SVGs are rendered at
+// each of those sizes rather than scaled. The rasters are kept in the cache
+// directory as raw pixels, keyed by path, modification time and file size,
+// so later launches don't decode the source at all.
+//
+// GUI thread only, the cache file is written on the thread pool.
+class IconCache {
+public:
+  enum Decoration {
+    Plain,
+    NotificationDot, // red dot in the top right corner
+  };
+
+  // The icon for an image file, or a null icon if it can't be read
+  static QIcon icon(const QString &path, Decoration decoration = Plain);
+
+  // Applies decoration to an icon that doesn't come from a file, such as a
+  // style icon. The result is kept in memory only.
+  static QIcon decorate(const QIcon &icon, Decoration decoration);
+
+  // Forgets the icons built by this process, the files in the cache stay.
+  // For when the device pixel ratio changes.
+  static void clearMemoryCache();
+
+  // Logical sizes every icon is rasterized at
+  static QList<int> iconSizes();
+
+  static QString cacheDirectory();
+
+private:
+  struct Source {
+    QString path;
+    qint64 modified = 0;
+    qint64 size = 0;
+    qreal devicePixelRatio = 1;
+    Decoration decoration = Plain;
+  };
+
+  static QString cachePath(const Source &source);
+  static QList<QImage> readCache(const Source &source);
+  static void writeCache(const Source &source, const QList<QImage> &images);
+  static QList<QImage> rasterize(const Source &source);
+  static void drawNotificationDot(QImage &image);
+  static QIcon toIcon(const QList<QImage> &images);
+};
+
+#endif // ICONCACHE_H
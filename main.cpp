@@ -1,21 +1,32 @@
 // Copyright(C) 2026 Joseph Crowell.
 // SPDX - License - Identifier : GPL-2.0-or-later
 
+#include "appconfig.h"
+#include "apphost.h"
 #include "browserwindow.h"
+#include "memoryprofile.h"
+#include "publicsuffixlist.h"
+#include "startupcoordinator.h"
+#include "startuptrace.h"
+#include "webapp.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
-#include <QDir>
 #include <QFileInfo>
 #include <QLocale>
 #include <QLoggingCategory>
-#include <QStandardPaths>
 #include <QString>
-#include <QStyle>
+#include <QSocketNotifier>
 #include <QTranslator>
 #include <QWebEngineProfile>
 #include <QWebEngineProfileBuilder>
-#include <QWebEngineSettings>
+#include <QWebEngineView>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using namespace Qt::StringLiterals;
 
@@ -63,7 +74,9 @@ static void setupWidevineCdm(const char *argv0) {
     return;
   }
 
+  StartupTrace::begin("findWidevineCdm");
   QString widevinePath = findWidevineCdm(argv0);
+  StartupTrace::end("findWidevineCdm");
   if (widevinePath.isEmpty()) {
     // Will warn later after logging is set up
     return;
@@ -86,7 +99,135 @@ static void setupWidevineCdm(const char *argv0) {
 #endif
 }
 
+#ifdef Q_OS_UNIX
+static int s_signalSockets[2] = {-1, -1};
+
+static void handleTerminationSignal(int) {
+  const char byte = 1;
+  [[maybe_unused]] const ssize_t sent = ::write(s_signalSockets[0], &byte, 1);
+}
+#endif
+
+// Quit through the event loop on SIGTERM and SIGINT, as at logout, so
+// windows save their state and profile data is flushed before exiting.
+// Signal handlers can't call Qt, so they only wake a socket notifier.
+static void quitOnTerminationSignals(QApplication &application) {
+#ifdef Q_OS_UNIX
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalSockets) != 0) {
+    qWarning() << "Could not install termination signal handlers";
+    return;
+  }
+
+  QSocketNotifier *notifier = new QSocketNotifier(
+      s_signalSockets[1], QSocketNotifier::Read, &application);
+  QObject::connect(notifier, &QSocketNotifier::activated, &application,
+                   [notifier]() {
+                     char byte;
+                     [[maybe_unused]] const ssize_t received =
+                         ::read(s_signalSockets[1], &byte, 1);
+                     notifier->setEnabled(false);
+                     QCoreApplication::quit();
+                   });
+
+  struct sigaction action = {};
+  action.sa_handler = handleTerminationSignal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGTERM, &action, nullptr);
+  sigaction(SIGINT, &action, nullptr);
+#else
+  Q_UNUSED(application);
+#endif
+}
+
+// Records when the app's first page starts and finishes loading and when its
+// first frame is on screen. The URL tells benchmarks whether the page they
+// asked for loaded, or an error page or the default start page. The profile
+// tells the apps of a launcher apart.
+static void traceFirstLoad(WebApp *app) {
+  if (!StartupTrace::isEnabled()) {
+    return;
+  }
+
+  const QString profile = app->config().profile();
+  QWebEngineView *view = app->window()->webView();
+  QObject::connect(
+      view, &QWebEngineView::loadStarted, view,
+      [profile]() {
+        StartupTrace::mark("firstLoadStarted", {{"profile", profile}});
+      },
+      Qt::SingleShotConnection);
+  QObject::connect(
+      view, &QWebEngineView::loadFinished, view,
+      [view, profile](bool ok) {
+        StartupTrace::mark("firstLoadFinished",
+                           {{"ok", ok},
+                            {"url", view->url().toString()},
+                            {"profile", profile}});
+        StartupTrace::write();
+      },
+      Qt::SingleShotConnection);
+  StartupTrace::markFirstFrame(view);
+}
+
+// Host mode: one process for all the apps in the config file. An app given
+// on the command line is added to them, or handed to the host that is already
+// running.
+static int runHost(QApplication &application, const QString &configPath,
+                   const AppConfig &commandLineApp, bool hasCommandLineApp) {
+  QList<AppConfig> apps;
+  if (hasCommandLineApp) {
+    apps.append(commandLineApp);
+  }
+
+  AppHost host;
+  if (!host.listen()) {
+    if (host.forward(apps)) {
+      qDebug() << "Host is already running, forwarded" << apps.size()
+               << "apps";
+      return 0;
+    }
+    qWarning() << "A host is running but not responding";
+    return 1;
+  }
+
+  apps = AppConfig::readFile(configPath.isEmpty() ? AppHost::defaultConfigPath()
+                                                  : configPath) +
+         apps;
+
+  // Apps close individually, the host quits with the last one
+  application.setQuitOnLastWindowClosed(false);
+  for (const AppConfig &config : std::as_const(apps)) {
+    host.open(config);
+  }
+
+  if (host.apps().isEmpty()) {
+    qWarning() << "No apps to host";
+    return 1;
+  }
+
+  traceFirstLoad(host.apps().first());
+  return application.exec();
+}
+
+// Launcher mode: stay resident with QtWebEngine initialized and open the apps
+// that normal launches hand over
+static int runLauncher(QApplication &application) {
+  AppHost launcher(AppHost::Launcher);
+  if (!launcher.listen()) {
+    qWarning() << "A launcher is already running";
+    return 1;
+  }
+
+  application.setQuitOnLastWindowClosed(false);
+  QObject::connect(&launcher, &AppHost::opened, &traceFirstLoad);
+  launcher.prewarm();
+  return application.exec();
+}
+
 int main(int argc, char *argv[]) {
+  StartupTrace::init(argc, argv);
+
   // Setup Widevine BEFORE QApplication (Qt WebEngine initializes with
   // QApplication)
   setupWidevineCdm(argv[0]);
@@ -100,7 +241,23 @@ int main(int argc, char *argv[]) {
     qputenv("QTWEBENGINE_CHROMIUM_FLAGS", flags);
   }
 
+  // Process model and V8 limits have to be set before QtWebEngine starts
+  const MemoryProfile::Preset memoryProfile =
+      MemoryProfile::fromArguments(argc, argv);
+  const QByteArrayList memoryFlags =
+      MemoryProfile::applyChromiumFlags(memoryProfile);
+
+  StartupTrace::begin("QApplication");
   QApplication application(argc, argv);
+  StartupTrace::end("QApplication");
+  quitOnTerminationSignals(application);
+  QObject::connect(&application, &QCoreApplication::aboutToQuit,
+                   &StartupTrace::write);
+
+  // Build the public suffix list off the GUI thread, before the first popup
+  // needs it
+  PublicSuffixList::loadAsync();
+  PublicSuffixList::watchSnapshot();
 
   // Log Widevine status after application is created
 #ifdef WIDEVINE_CDM_ENABLED
@@ -115,6 +272,16 @@ int main(int argc, char *argv[]) {
   qDebug() << "Widevine CDM support not compiled in (ENABLE_WIDEVINE=OFF)";
 #endif
 
+  // Logged in release builds too, memory reports need to know the preset
+  if (memoryProfile != MemoryProfile::Default) {
+    qInfo().noquote() << "Memory profile" << MemoryProfile::name(memoryProfile)
+                      << "added" << memoryFlags.join(' ') << "and a"
+                      << MemoryProfile::httpCacheSize(memoryProfile) /
+                             (1024 * 1024)
+                      << "MB HTTP cache. Chromium flags:"
+                      << qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+  }
+
 #ifdef QT_DEBUG
   QLoggingCategory::setFilterRules(u"qt.webenginecontext.debug=true"_s);
 #else
@@ -125,6 +292,7 @@ int main(int argc, char *argv[]) {
   application.setApplicationName("Web App Container");
   application.setApplicationVersion("1.0.0");
 
+  StartupTrace::begin("loadTranslator");
   QTranslator translator;
   const QStringList uiLanguages = QLocale::system().uiLanguages();
   for (const QString &locale : uiLanguages) {
@@ -134,6 +302,7 @@ int main(int argc, char *argv[]) {
       break;
     }
   }
+  StartupTrace::end("loadTranslator");
 
   // Get command line arguments
   QCommandLineParser parser;
@@ -175,127 +344,167 @@ int main(int argc, char *argv[]) {
       "Start the application minimized to the tray.");
   parser.addOption(minimizedOption);
 
+  QCommandLineOption minimizedLoadOption(
+      QStringList() << "minimized-load",
+      "When a minimized app loads its URL: immediate (default), idle or "
+      "restore.",
+      "policy", "immediate");
+  parser.addOption(minimizedLoadOption);
+
   QCommandLineOption notifyOption(
       QStringList() << "no-notify",
       "Don't notify when minimizing or closing to the tray.");
   parser.addOption(notifyOption);
 
+  QCommandLineOption readaheadOption(
+      QStringList() << "no-readahead",
+      "Don't read the profile's files into memory ahead of Chromium.");
+  parser.addOption(readaheadOption);
+
+  QCommandLineOption notificationLimitOption(
+      QStringList() << "notification-limit",
+      "Show at most n notifications every 2 seconds, and a summary of the "
+      "rest (default: 2).",
+      "n", "2");
+  parser.addOption(notificationLimitOption);
+
+  // Read by MemoryProfile::fromArguments() before QApplication exists
+  QCommandLineOption memoryProfileOption(
+      QStringList() << "memory-profile",
+      "Trade speed for memory: low, balanced or performance.", "preset");
+  parser.addOption(memoryProfileOption);
+
+  // Read by StartupTrace::init() before QApplication exists
+  QCommandLineOption startupTraceOption(
+      QStringList() << "startup-trace",
+      "Write startup phase timings as Chrome trace-event JSON to file.",
+      "file");
+  parser.addOption(startupTraceOption);
+
+  QCommandLineOption hostOption(
+      QStringList() << "host",
+      "Run the apps from the host config file, and any app given on the "
+      "command line, in one process. If a host is already running, the app "
+      "is added to it.");
+  parser.addOption(hostOption);
+
+  QCommandLineOption configOption(
+      QStringList() << "config",
+      "The host config file (default: " + AppHost::defaultConfigPath() + ").",
+      "file");
+  parser.addOption(configOption);
+
+  QCommandLineOption launcherOption(
+      QStringList() << "launcher",
+      "Stay in the background with the web engine initialized, and open apps "
+      "that are launched later in this process.");
+  parser.addOption(launcherOption);
+
+  QCommandLineOption noLauncherOption(
+      QStringList() << "no-launcher",
+      "Start in a new process even if a launcher is running.");
+  parser.addOption(noLauncherOption);
+
   parser.process(application);
-  QString startUrl = parser.value(urlOption);
-  QString appId = parser.value(appIdOption);
-  QString profileName = parser.value(profileOption);
-  QString appName = parser.value(nameOption);
-  QString iconPath = parser.value(iconOption);
-  QString trayIconPath = parser.value(trayIconOption);
-  bool startMinimized = parser.isSet(minimizedOption);
-  bool notify = !parser.isSet(notifyOption);
-
-  if (!appId.isEmpty()) {
-    QString desktopPath =
-        QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation) +
-        "/" + appId + ".desktop";
-
-    if (QFile::exists(desktopPath) ||
-        QFile::exists("/usr/share/applications/" + appId + ".desktop")) {
-      QApplication::setDesktopFileName(appId);
+
+  AppConfig config;
+  config.url = AppConfig::urlFromArgument(parser.value(urlOption));
+  config.appId = parser.value(appIdOption);
+  config.profileName = parser.value(profileOption);
+  config.appName = parser.value(nameOption);
+  config.iconPath = parser.value(iconOption);
+  config.trayIconPath = parser.value(trayIconOption);
+  config.startMinimized = parser.isSet(minimizedOption);
+  config.notify = !parser.isSet(notifyOption);
+  config.readahead = !parser.isSet(readaheadOption);
+  config.notificationLimit = parser.value(notificationLimitOption).toInt();
+  if (!AppConfig::minimizedLoadFromString(parser.value(minimizedLoadOption),
+                                          config.minimizedLoad)) {
+    qWarning() << "Unknown --minimized-load"
+               << parser.value(minimizedLoadOption) << "- loading immediately";
+  }
+
+  if (parser.isSet(launcherOption)) {
+    return runLauncher(application);
+  }
+
+  if (parser.isSet(hostOption)) {
+    return runHost(application, parser.value(configOption), config,
+                   parser.isSet(urlOption) || parser.isSet(profileOption));
+  }
+
+  if (!config.appId.isEmpty()) {
+    if (config.hasDesktopFile()) {
+      QApplication::setDesktopFileName(config.appId);
     } else {
-      qWarning() << "No desktop file found for" << appId
+      qWarning() << "No desktop file found for" << config.appId
                  << "- skipping Portal registration.";
     }
   }
 
   // If we have an app name, set it
-  if (!appName.isEmpty()) {
-    application.setApplicationName(appName);
-    application.setApplicationDisplayName(appName);
+  if (!config.appName.isEmpty()) {
+    application.setApplicationName(config.appName);
+    application.setApplicationDisplayName(config.appName);
   }
 
-  QString baseRoot =
-      QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
-  QString name = profileName.isEmpty() ? u"default"_s : profileName;
-  QString profilePath;
-  profilePath =
-      baseRoot + QDir::separator() + "QtWebEngine" + QDir::separator() + name;
-  QDir().mkpath(profilePath);
-
-  // Create the profile and set paths
-  QWebEngineProfile *profile = new QWebEngineProfile(name);
-  profile->setPersistentStoragePath(profilePath);
-  profile->setCachePath(profilePath + QDir::separator() + "cache");
-
-  // Set policies
-  profile->setPersistentPermissionsPolicy(
-      QWebEngineProfile::PersistentPermissionsPolicy::StoreOnDisk);
-  profile->setPersistentCookiesPolicy(
-      QWebEngineProfile::AllowPersistentCookies);
-
-  // Enable Web Push API for service worker push notifications
-  profile->setPushServiceEnabled(true);
-
-  // Set remaining profile settings
-  profile->settings()->setAttribute(QWebEngineSettings::JavascriptEnabled,
-                                    true);
-  profile->settings()->setAttribute(QWebEngineSettings::LocalStorageEnabled,
-                                    true);
-  profile->settings()->setAttribute(QWebEngineSettings::PluginsEnabled, true);
-  profile->settings()->setAttribute(QWebEngineSettings::DnsPrefetchEnabled,
-                                    true);
-  profile->settings()->setAttribute(
-      QWebEngineSettings::LocalContentCanAccessRemoteUrls, true);
-  profile->settings()->setAttribute(
-      QWebEngineSettings::LocalContentCanAccessFileUrls, false);
-  profile->settings()->setAttribute(QWebEngineSettings::ScreenCaptureEnabled,
-                                    true);
-  profile->setHttpUserAgent(
-      "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
-      "Chrome/143.0.7499.169/170 Safari/537.36");
-
-  if (profile->isOffTheRecord()) {
-    qWarning() << "Warning: Profile is still Off-The-Record! This should not "
-                  "happen with a named profile.";
-  } else {
-    qDebug() << "Profile is On-The-Record (Persistent). Storage path:"
-             << profile->persistentStoragePath();
+  // A running launcher opens the app without initializing another runtime
+  if (!parser.isSet(noLauncherOption)) {
+    AppHost launcher(AppHost::Launcher);
+    if (launcher.forward({config})) {
+      qDebug() << "Opened" << config.profile() << "in the launcher";
+      return 0;
+    }
   }
 
   int result = 0;
   {
-    BrowserWindow *window =
-        new BrowserWindow(profile, appName, iconPath, trayIconPath, notify);
-
-    if (window->isValidImage(iconPath)) {
-      application.setWindowIcon(QIcon(iconPath));
-    } else {
-      application.setWindowIcon(
-          window->style()->standardIcon(QStyle::SP_TitleBarMenuButton));
-    }
-
-    // Set an initial URL
-    if (startUrl.isEmpty()) {
-      window->webView()->setUrl(QUrl("https://www.google.com"));
-    } else {
-      QUrl url(startUrl);
-
-      // If no scheme is provided, default to https
-      if (url.scheme().isEmpty()) {
-        url = QUrl("https://" + startUrl);
+    WebApp app(config);
+
+    // Only one process may use a profile. If it is already running, hand it
+    // this launch and exit before starting a second Chromium instance.
+    if (!app.claimProfile()) {
+      if (app.forwardToRunningInstance()) {
+        qDebug() << "Profile" << config.profile()
+                 << "is already running, forwarded launch";
+        return 0;
       }
-
-      window->webView()->setUrl(url);
+      qWarning() << "Profile" << config.profile()
+                 << "is locked by an instance that is not responding, "
+                    "starting anyway";
     }
 
-    if (startMinimized) {
-      window->show();
-      window->hide();
-    } else {
-      window->show();
-    }
-    result = application.exec();
+    // Take turns with other instances starting at the same time, e.g. at
+    // login. Minimized apps let the ones the user is looking at go first.
+    // The wait runs in the event loop, so a second launch of this profile
+    // is answered meanwhile instead of starting another Chromium.
+    StartupCoordinator coordinator(config.startMinimized
+                                       ? StartupCoordinator::Background
+                                       : StartupCoordinator::Foreground);
+    QObject::connect(
+        &coordinator, &StartupCoordinator::ready, &app,
+        [&]() {
+          app.start();
+          // A minimized app that defers its start URL has no first load to
+          // hold the slot for, the other apps starting now can have it
+          if (app.isStartUrlDeferred()) {
+            coordinator.release();
+          } else {
+            coordinator.releaseAfterFirstLoad(app.window()->webView());
+          }
+          traceFirstLoad(&app);
+
+          // The window decoded the icon already, this comes from the same
+          // cache
+          application.setWindowIcon(app.window()->windowIcon());
+        },
+        Qt::SingleShotConnection);
+    QObject::connect(&app, &WebApp::quitRequested, &application,
+                     &QCoreApplication::quit);
+    coordinator.acquire();
 
-    delete window;
+    result = application.exec();
   }
 
-  delete profile;
-
   return result;
 }
@@ -0,0 +1,135 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "memoryprofile.h"
+
+#include <QDebug>
+#include <QWebEngineProfile>
+
+MemoryProfile::Preset MemoryProfile::s_active = MemoryProfile::Default;
+
+bool MemoryProfile::fromString(const QString &name, Preset &preset) {
+  if (name == "low") {
+    preset = Low;
+  } else if (name == "balanced") {
+    preset = Balanced;
+  } else if (name == "performance") {
+    preset = Performance;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+QString MemoryProfile::name(Preset preset) {
+  switch (preset) {
+  case Low:
+    return "low";
+  case Balanced:
+    return "balanced";
+  case Performance:
+    return "performance";
+  case Default:
+    break;
+  }
+  return "default";
+}
+
+MemoryProfile::Preset MemoryProfile::fromArguments(int argc, char *argv[]) {
+  QString value;
+  for (int i = 1; i < argc; ++i) {
+    const QByteArray arg(argv[i]);
+    if (arg.startsWith("--memory-profile=")) {
+      value = QString::fromLocal8Bit(arg.mid(qstrlen("--memory-profile=")));
+    } else if (arg == "--memory-profile" && i + 1 < argc) {
+      value = QString::fromLocal8Bit(argv[i + 1]);
+    }
+  }
+
+  Preset preset = Default;
+  if (!value.isEmpty() && !fromString(value, preset)) {
+    qWarning() << "Unknown --memory-profile" << value
+               << "- using Chromium defaults";
+  }
+  s_active = preset;
+  return preset;
+}
+
+QByteArrayList MemoryProfile::chromiumFlags(Preset preset) {
+  switch (preset) {
+  case Low:
+    // Few renderers shared by all pages of a site, no out-of-process
+    // iframes, a small V8 heap, and rasterization on the CPU with a single
+    // thread
+    return {
+        "--renderer-process-limit=2",
+        "--process-per-site",
+        "--disable-site-isolation-trials",
+        "--js-flags=--max-old-space-size=256",
+        "--disable-gpu-rasterization",
+        "--num-raster-threads=1",
+    };
+  case Balanced:
+    // Site isolation stays on, but renderers are shared per site and capped
+    return {
+        "--renderer-process-limit=4",
+        "--process-per-site",
+        "--js-flags=--max-old-space-size=512",
+    };
+  case Performance:
+    // No process limits, and rasterization on the GPU where there is one
+    return {
+        "--enable-gpu-rasterization",
+        "--enable-zero-copy",
+        "--num-raster-threads=4",
+    };
+  case Default:
+    break;
+  }
+  return {};
+}
+
+int MemoryProfile::httpCacheSize(Preset preset) {
+  switch (preset) {
+  case Low:
+    return 32 * 1024 * 1024;
+  case Balanced:
+    return 64 * 1024 * 1024;
+  case Performance:
+    return 256 * 1024 * 1024;
+  case Default:
+    break;
+  }
+  return 0;
+}
+
+QByteArrayList MemoryProfile::applyChromiumFlags(Preset preset) {
+  QByteArray flags = qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+  QByteArrayList applied;
+
+  const QByteArrayList presetFlags = chromiumFlags(preset);
+  for (const QByteArray &flag : presetFlags) {
+    // Compare the switch name only, "--js-flags=..." overrides ours
+    const QByteArray name = flag.left(flag.indexOf('='));
+    if (flags.contains(name)) {
+      continue;
+    }
+    // QtWebEngine splits the variable on spaces, so a switch can't contain
+    // one. That's why each --js-flags carries a single V8 flag.
+    if (!flags.isEmpty()) {
+      flags += " ";
+    }
+    flags += flag;
+    applied.append(flag);
+  }
+
+  qputenv("QTWEBENGINE_CHROMIUM_FLAGS", flags);
+  return applied;
+}
+
+void MemoryProfile::applyToProfile(Preset preset,
+                                   QWebEngineProfile *profile) {
+  if (const int size = httpCacheSize(preset)) {
+    profile->setHttpCacheMaximumSize(size);
+  }
+}
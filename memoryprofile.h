@@ -0,0 +1,52 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef MEMORYPROFILE_H
+#define MEMORYPROFILE_H
+
+#include <QByteArrayList>
+#include <QString>
+
+class QWebEngineProfile;
+
+// --memory-profile presets that trade speed for memory. Each one is a
+// coherent bundle of Chromium switches (process model, site isolation, V8
+// heap and GPU rasterization) plus a disk cache size.
+class MemoryProfile {
+public:
+  enum Preset {
+    Default, // no option given: Chromium's own defaults
+    Low,
+    Balanced,
+    Performance,
+  };
+
+  static bool fromString(const QString &name, Preset &preset);
+  static QString name(Preset preset);
+
+  // Reads --memory-profile from argv and makes it the active preset. The
+  // switches have to be in place before QtWebEngine initializes, which is
+  // before QCommandLineParser can run.
+  static Preset fromArguments(int argc, char *argv[]);
+
+  // The preset of this process. Chromium switches are process wide, so all
+  // apps in a host share it.
+  static Preset active() { return s_active; }
+
+  static QByteArrayList chromiumFlags(Preset preset);
+
+  // Maximum HTTP disk cache size in bytes, 0 lets Chromium decide
+  static int httpCacheSize(Preset preset);
+
+  // Adds the preset's switches to QTWEBENGINE_CHROMIUM_FLAGS. A switch the
+  // user already set there wins over the preset. Returns the switches that
+  // were added.
+  static QByteArrayList applyChromiumFlags(Preset preset);
+
+  static void applyToProfile(Preset preset, QWebEngineProfile *profile);
+
+private:
+  static Preset s_active;
+};
+
+#endif // MEMORYPROFILE_H
@@ -0,0 +1,146 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "notificationcoalescer.h"
+
+#include <QDebug>
+#include <QWebEngineNotification>
+
+#include <algorithm>
+
+NotificationCoalescer::NotificationCoalescer(int limit, int windowMs,
+                                             QObject *parent)
+    : QObject(parent), m_limit(std::max(1, limit)) {
+  m_window.setSingleShot(true);
+  m_window.setInterval(windowMs);
+  connect(&m_window, &QTimer::timeout, this,
+          &NotificationCoalescer::endWindow);
+}
+
+void NotificationCoalescer::setLimit(int limit) {
+  m_limit = std::max(1, limit);
+}
+
+void NotificationCoalescer::add(
+    std::unique_ptr<QWebEngineNotification> notification) {
+  QWebEngineNotification *raw = notification.get();
+  connect(raw, &QWebEngineNotification::closed, this,
+          [this, raw]() { remove(raw); });
+  const QUrl origin = raw->origin();
+  const QString tag = raw->tag();
+  add(origin, tag, std::move(notification));
+}
+
+void NotificationCoalescer::add(const QUrl &origin, const QString &tag,
+                                std::unique_ptr<QObject> notification) {
+  ++m_counters.received;
+
+  Entry entry{origin.toString() + '\n' +
+                  (tag.isEmpty() ? "#" + QString::number(++m_untagged) : tag),
+              std::move(notification)};
+
+  // An update of one that is waiting takes its place in the line
+  auto pending = std::find_if(
+      m_pending.begin(), m_pending.end(),
+      [&entry](const Entry &other) { return other.key == entry.key; });
+  if (pending != m_pending.end()) {
+    release(pending->notification);
+    *pending = std::move(entry);
+    ++m_counters.coalesced;
+    return;
+  }
+
+  // An update of the one shown replaces it on the desktop. It is still one
+  // notification, so the window's budget stays as it is.
+  if (m_current.notification && m_current.key == entry.key) {
+    release(m_current.notification);
+    m_current = std::move(entry);
+    ++m_counters.coalesced;
+    emit delivered(m_current.notification.get());
+    return;
+  }
+
+  if (m_deliveredInWindow < m_limit) {
+    deliver(std::move(entry));
+  } else {
+    m_pending.push_back(std::move(entry));
+  }
+}
+
+void NotificationCoalescer::remove(QObject *notification) {
+  if (m_current.notification.get() == notification) {
+    release(m_current.notification);
+    m_current.key.clear();
+    return;
+  }
+  auto pending = std::find_if(m_pending.begin(), m_pending.end(),
+                              [notification](const Entry &entry) {
+                                return entry.notification.get() ==
+                                       notification;
+                              });
+  if (pending != m_pending.end()) {
+    release(pending->notification);
+    m_pending.erase(pending);
+  }
+}
+
+std::unique_ptr<QObject> NotificationCoalescer::takeCurrent() {
+  m_current.key.clear();
+  return std::move(m_current.notification);
+}
+
+void NotificationCoalescer::deliver(Entry entry) {
+  // The desktop shows one at a time, the one it showed before is gone
+  release(m_current.notification);
+  m_current = std::move(entry);
+
+  ++m_counters.delivered;
+  ++m_deliveredInWindow;
+  if (!m_window.isActive()) {
+    m_window.start();
+  }
+  emit delivered(m_current.notification.get());
+}
+
+void NotificationCoalescer::endWindow() {
+  m_deliveredInWindow = 0;
+  if (m_pending.empty()) {
+    return;
+  }
+
+  std::vector<Entry> pending = std::move(m_pending);
+  m_pending.clear();
+  if (static_cast<int>(pending.size()) <= m_limit) {
+    for (Entry &entry : pending) {
+      deliver(std::move(entry));
+    }
+    return;
+  }
+
+  const int count = static_cast<int>(pending.size());
+  for (int i = 0; i < count - 1; ++i) {
+    release(pending[i].notification);
+  }
+  // The desktop shows the summary, an update of its last notification is
+  // a new notification rather than a replacement of the summary
+  release(m_current.notification);
+  m_current = std::move(pending.back());
+  m_current.key.clear();
+
+  m_counters.dropped += count;
+  ++m_counters.summaries;
+  ++m_deliveredInWindow;
+  m_window.start();
+
+  qDebug() << "Summarized" << count << "notifications," << m_counters.received
+           << "received," << m_counters.delivered << "delivered,"
+           << m_counters.coalesced << "coalesced," << m_counters.dropped
+           << "dropped";
+  emit summarized(count, m_current.notification.get());
+}
+
+void NotificationCoalescer::release(std::unique_ptr<QObject> &notification) {
+  if (notification) {
+    notification.release()->deleteLater();
+  }
+}
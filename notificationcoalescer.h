@@ -0,0 +1,94 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef NOTIFICATIONCOALESCER_H
+#define NOTIFICATIONCOALESCER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+
+#include <memory>
+#include <vector>
+
+class QWebEngineNotification;
+
+// Decides which of an app's web notifications reach the desktop, so a burst
+// (a chat app catching up after sleep) doesn't flood it.
+//
+// A notification with the tag and origin of one that is waiting or shown
+// replaces it. Replacing the shown one delivers the update at once, without
+// counting against the limit. At most limit notifications are delivered in
+// windowMs. Any more wait for the end of the window: up to limit are
+// delivered then, more are shown as one summary.
+//
+// Owns the notifications it is given. Only the one that was delivered last
+// is kept for clicks, the others are released.
+class NotificationCoalescer : public QObject {
+  Q_OBJECT
+
+public:
+  struct Counters {
+    int received = 0;
+    // Shown one by one
+    int delivered = 0;
+    // Replaced by a later one with the same tag, waiting or shown
+    int coalesced = 0;
+    // Folded into a summary
+    int dropped = 0;
+    int summaries = 0;
+  };
+
+  explicit NotificationCoalescer(int limit = 2, int windowMs = 2000,
+                                 QObject *parent = nullptr);
+
+  int limit() const { return m_limit; }
+  // At least 1
+  void setLimit(int limit);
+
+  // Released when its page closes it
+  void add(std::unique_ptr<QWebEngineNotification> notification);
+  // An empty tag is never coalesced
+  void add(const QUrl &origin, const QString &tag,
+           std::unique_ptr<QObject> notification);
+  // Called when the page closed notification
+  void remove(QObject *notification);
+
+  // What the desktop shows, null if it was closed
+  QObject *current() const { return m_current.notification.get(); }
+  // Hands it over, e.g. to pass a click to its page
+  std::unique_ptr<QObject> takeCurrent();
+
+  // Waiting for the end of the window
+  int pendingCount() const { return static_cast<int>(m_pending.size()); }
+  const Counters &counters() const { return m_counters; }
+
+signals:
+  // Show notification. An update of the one shown is delivered too.
+  void delivered(QObject *notification);
+  // count notifications came too fast to be shown one by one, latest is the
+  // last of them
+  void summarized(int count, QObject *latest);
+
+private:
+  struct Entry {
+    QString key;
+    std::unique_ptr<QObject> notification;
+  };
+
+  void deliver(Entry entry);
+  void endWindow();
+  // Deleted later, it may be in the middle of emitting a signal
+  static void release(std::unique_ptr<QObject> &notification);
+
+  int m_limit;
+  QTimer m_window;
+  int m_deliveredInWindow = 0;
+  std::vector<Entry> m_pending;
+  Entry m_current;
+  Counters m_counters;
+  quint64 m_untagged = 0;
+};
+
+#endif // NOTIFICATIONCOALESCER_H
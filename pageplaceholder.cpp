@@ -0,0 +1,140 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "pageplaceholder.h"
+
+#include <QDebug>
+#include <QEvent>
+#include <QFutureWatcher>
+#include <QGraphicsOpacityEffect>
+#include <QPainter>
+#include <QPromise>
+#include <QPropertyAnimation>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWebEngineView>
+
+#include <memory>
+
+// Snapshots are stored at half the view's size. That is plenty for a few
+// seconds behind a fade and keeps encoding and decoding cheap.
+static constexpr qreal snapshotScale = 0.5;
+static constexpr int fadeDurationMs = 200;
+// Fade out even if the page never finishes loading
+static constexpr int maximumShowMs = 15000;
+
+PagePlaceholder::PagePlaceholder(QWebEngineView *view, const QString &path)
+    : QWidget(view->parentWidget()), m_view(view), m_path(path) {
+  // Clicks go to the page underneath
+  setAttribute(Qt::WA_TransparentForMouseEvents);
+  setAttribute(Qt::WA_OpaquePaintEvent);
+  hide();
+
+  view->installEventFilter(this);
+  connect(view, &QWebEngineView::loadFinished, this, [this](bool ok) {
+    if (ok) {
+      m_pageLoaded = true;
+      // Give the page a frame to render before revealing it
+      QTimer::singleShot(0, this, &PagePlaceholder::fadeOut);
+    }
+  });
+
+  auto promise = std::make_shared<QPromise<QImage>>();
+  QFuture<QImage> loading = promise->future();
+  promise->start();
+  QThreadPool::globalInstance()->start([promise, path]() {
+    promise->addResult(QImage(path));
+    promise->finish();
+  });
+
+  auto *watcher = new QFutureWatcher<QImage>(this);
+  connect(watcher, &QFutureWatcher<QImage>::finished, this,
+          [this, watcher]() {
+            showSnapshot(watcher->result());
+            watcher->deleteLater();
+          });
+  watcher->setFuture(loading);
+}
+
+PagePlaceholder::~PagePlaceholder() {
+  // A snapshot saved on quit must reach the disk
+  m_saving.waitForFinished();
+}
+
+void PagePlaceholder::showSnapshot(const QImage &image) {
+  // No snapshot yet, or the page was quicker than the disk
+  if (image.isNull() || m_pageLoaded || !m_view) {
+    return;
+  }
+
+  m_image = image;
+  setGeometry(m_view->geometry());
+  raise();
+  show();
+  QTimer::singleShot(maximumShowMs, this, &PagePlaceholder::fadeOut);
+}
+
+void PagePlaceholder::fadeOut() {
+  if (!isVisible() || graphicsEffect()) {
+    return;
+  }
+
+  auto *effect = new QGraphicsOpacityEffect(this);
+  setGraphicsEffect(effect);
+  auto *animation = new QPropertyAnimation(effect, "opacity", this);
+  animation->setDuration(fadeDurationMs);
+  animation->setStartValue(1.0);
+  animation->setEndValue(0.0);
+  connect(animation, &QPropertyAnimation::finished, this, [this]() {
+    hide();
+    setGraphicsEffect(nullptr);
+    // Not needed again until the next start
+    m_image = QImage();
+  });
+  animation->start(QAbstractAnimation::DeleteWhenStopped);
+}
+
+void PagePlaceholder::save() {
+  if (!m_pageLoaded || !m_view || !m_view->isVisible() ||
+      m_saving.isRunning()) {
+    return;
+  }
+
+  // Grabbing has to happen on the GUI thread; scaling and encoding don't
+  const QImage frame = m_view->grab().toImage();
+  if (frame.isNull()) {
+    return;
+  }
+  const QSize size = (QSizeF(m_view->size()) * snapshotScale).toSize();
+
+  auto promise = std::make_shared<QPromise<void>>();
+  m_saving = promise->future();
+  promise->start();
+  QThreadPool::globalInstance()->start([promise, frame, size,
+                                        path = m_path]() {
+    const QImage scaled =
+        frame.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly) && scaled.save(&file, "JPG", 80)) {
+      file.commit();
+    } else {
+      qWarning() << "Could not save page snapshot to" << path;
+    }
+    promise->finish();
+  });
+}
+
+bool PagePlaceholder::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_view &&
+      (event->type() == QEvent::Resize || event->type() == QEvent::Move)) {
+    setGeometry(m_view->geometry());
+  }
+  return QWidget::eventFilter(watched, event);
+}
+
+void PagePlaceholder::paintEvent(QPaintEvent *) {
+  QPainter painter(this);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+  painter.drawImage(rect(), m_image);
+}
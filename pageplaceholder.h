@@ -0,0 +1,45 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef PAGEPLACEHOLDER_H
+#define PAGEPLACEHOLDER_H
+
+#include <QFuture>
+#include <QImage>
+#include <QPointer>
+#include <QString>
+#include <QWidget>
+
+class QWebEngineView;
+
+// Covers the web view with the frame it showed when the app was last hidden
+// or closed, until the page has rendered again, so a heavy app doesn't start
+// as a blank window. The snapshot is decoded and encoded on worker threads.
+class PagePlaceholder : public QWidget {
+  Q_OBJECT
+
+public:
+  PagePlaceholder(QWebEngineView *view, const QString &path);
+  ~PagePlaceholder();
+
+  // Grabs the view and writes a downscaled snapshot for the next start. Only
+  // does so once the page has loaded, so a blank or half loaded view never
+  // replaces a good snapshot.
+  void save();
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+  void paintEvent(QPaintEvent *event) override;
+
+private:
+  void showSnapshot(const QImage &image);
+  void fadeOut();
+
+  QPointer<QWebEngineView> m_view;
+  QString m_path;
+  QImage m_image;
+  QFuture<void> m_saving;
+  bool m_pageLoaded = false;
+};
+
+#endif // PAGEPLACEHOLDER_H
@@ -0,0 +1,277 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "permissionstore.h"
+#include "settingsstore.h"
+
+#include <QWebEngineProfile>
+
+#include <algorithm>
+
+// Grants settings.ini remembers:
+// Permissions/granted/<percent encoded origin>/<type>=<expiry or empty>
+static const QString recordGroup = QStringLiteral("Permissions/granted/");
+
+// Grants of older versions: Permissions/grants/<host, . as _>/<type>=true.
+// They are moved to the records above with the host as origin.
+static const QString legacyGroup = QStringLiteral("Permissions/grants/");
+
+// Longest wait of the expiry timer, QTimer takes an int
+static constexpr qint64 maxExpiryWaitMs = 24 * 60 * 60 * 1000;
+
+PermissionStore *PermissionStore::forProfile(QWebEngineProfile *profile) {
+  auto *store = profile->findChild<PermissionStore *>(
+      QString(), Qt::FindDirectChildrenOnly);
+  if (!store) {
+    store = new PermissionStore(
+        SettingsStore::forProfile(profile->persistentStoragePath()), profile);
+    store->attach(profile);
+  }
+  return store;
+}
+
+PermissionStore::PermissionStore(SettingsStore *settings, QObject *parent)
+    : QObject(parent), m_settings(settings) {
+  m_expiryTimer.setSingleShot(true);
+  connect(&m_expiryTimer, &QTimer::timeout, this,
+          &PermissionStore::removeExpired);
+  load();
+}
+
+QString PermissionStore::originKey(const QUrl &origin) {
+  QString key = origin.scheme() + "://" + origin.host();
+  if (origin.port() != -1) {
+    key += ':' + QString::number(origin.port());
+  }
+  return key;
+}
+
+QString PermissionStore::recordKey(const QString &origin, int type) {
+  return recordGroup + QString::fromLatin1(QUrl::toPercentEncoding(origin)) +
+         '/' + QString::number(type);
+}
+
+void PermissionStore::load() {
+  const QDateTime now = QDateTime::currentDateTimeUtc();
+
+  const QStringList records = m_settings->keys(recordGroup);
+  for (const QString &key : records) {
+    const QStringList parts = key.mid(recordGroup.size()).split('/');
+    bool ok = false;
+    const int type = parts.value(1).toInt(&ok);
+    if (parts.size() != 2 || !ok) {
+      continue;
+    }
+
+    Grant grant{QUrl::fromPercentEncoding(parts[0].toLatin1()),
+                static_cast<QWebEnginePermission::PermissionType>(type),
+                QDateTime::fromString(m_settings->value(key).toString(),
+                                      Qt::ISODateWithMs)};
+    if (grant.isExpired(now)) {
+      m_settings->remove(key);
+      continue;
+    }
+    m_grants.insert(Key(grant.origin, type), grant);
+  }
+
+  // The host was all the old key kept, and the grant was for any scheme and
+  // port of it. Which ones the user meant is unknown, so it stays that way.
+  const QStringList legacy = m_settings->keys(legacyGroup);
+  for (const QString &key : legacy) {
+    const QStringList parts = key.mid(legacyGroup.size()).split('/');
+    bool ok = false;
+    const int type = parts.value(1).toInt(&ok);
+    if (parts.size() == 2 && ok && m_settings->value(key).toBool()) {
+      QString host = parts[0];
+      insert({host.replace('_', '.'),
+              static_cast<QWebEnginePermission::PermissionType>(type),
+              QDateTime()});
+    }
+    m_settings->remove(key);
+  }
+
+  scheduleExpiry();
+}
+
+void PermissionStore::attach(QWebEngineProfile *profile) {
+  m_profile = profile;
+
+  // A host alone is no origin Chromium could be given. Those grants are
+  // handed over origin by origin as pages ask for them.
+  for (const Grant &grant : std::as_const(m_grants)) {
+    if (QWebEnginePermission::isPersistent(grant.type) &&
+        !isHostOnly(grant.origin)) {
+      QWebEnginePermission permission =
+          profile->queryPermission(QUrl(grant.origin), grant.type);
+      if (permission.state() != QWebEnginePermission::State::Granted) {
+        permission.grant();
+      }
+    }
+    updateRecord(grant);
+  }
+
+  const QList<QWebEnginePermission> permissions =
+      profile->listAllPermissions();
+  for (const QWebEnginePermission &permission : permissions) {
+    if (permission.state() != QWebEnginePermission::State::Granted) {
+      continue;
+    }
+    const QString origin = originKey(permission.origin());
+    const int type = static_cast<int>(permission.permissionType());
+    if (!m_grants.contains(Key(origin, type))) {
+      m_grants.insert(Key(origin, type),
+                      {origin, permission.permissionType(), QDateTime()});
+    }
+  }
+
+  removeExpired();
+}
+
+bool PermissionStore::isGranted(const QUrl &origin,
+                                QWebEnginePermission::PermissionType type) {
+  Key key(originKey(origin), static_cast<int>(type));
+  auto it = m_grants.constFind(key);
+  if (it == m_grants.cend()) {
+    key.first = origin.host();
+    it = m_grants.constFind(key);
+  }
+  if (it == m_grants.cend()) {
+    return false;
+  }
+  if (it->isExpired(QDateTime::currentDateTimeUtc())) {
+    remove(key);
+    scheduleExpiry();
+    return false;
+  }
+  return true;
+}
+
+void PermissionStore::grant(const QUrl &origin,
+                            QWebEnginePermission::PermissionType type,
+                            const QDateTime &expires) {
+  if (m_profile && QWebEnginePermission::isPersistent(type)) {
+    QWebEnginePermission permission = m_profile->queryPermission(origin, type);
+    if (permission.state() != QWebEnginePermission::State::Granted) {
+      permission.grant();
+    }
+  }
+  insert({originKey(origin), type,
+          expires.isValid() ? expires.toUTC() : QDateTime()});
+  scheduleExpiry();
+}
+
+void PermissionStore::revoke(const QUrl &origin,
+                             QWebEnginePermission::PermissionType type) {
+  remove(Key(originKey(origin), static_cast<int>(type)));
+  remove(Key(origin.host(), static_cast<int>(type)));
+  scheduleExpiry();
+}
+
+int PermissionStore::revokeOrigin(const QUrl &origin) {
+  const QString key = originKey(origin);
+  const QString host = origin.host();
+  QList<Key> keys;
+  for (auto it = m_grants.cbegin(); it != m_grants.cend(); ++it) {
+    if (it.key().first == key || it.key().first == host) {
+      keys.append(it.key());
+    }
+  }
+  for (const Key &key : std::as_const(keys)) {
+    remove(key);
+  }
+  scheduleExpiry();
+  return keys.size();
+}
+
+QList<PermissionStore::Grant> PermissionStore::grants() const {
+  return grantsForOrigin(QUrl());
+}
+
+QList<PermissionStore::Grant>
+PermissionStore::grantsForOrigin(const QUrl &origin) const {
+  const QString key = origin.isEmpty() ? QString() : originKey(origin);
+  const QString host = origin.host();
+  const QDateTime now = QDateTime::currentDateTimeUtc();
+
+  QList<Grant> grants;
+  for (const Grant &grant : m_grants) {
+    if ((key.isEmpty() || grant.origin == key || grant.origin == host) &&
+        !grant.isExpired(now)) {
+      grants.append(grant);
+    }
+  }
+  std::sort(grants.begin(), grants.end(),
+            [](const Grant &a, const Grant &b) {
+              return std::pair(a.origin, static_cast<int>(a.type)) <
+                     std::pair(b.origin, static_cast<int>(b.type));
+            });
+  return grants;
+}
+
+int PermissionStore::removeExpired() {
+  const QDateTime now = QDateTime::currentDateTimeUtc();
+  QList<Key> keys;
+  for (auto it = m_grants.cbegin(); it != m_grants.cend(); ++it) {
+    if (it->isExpired(now)) {
+      keys.append(it.key());
+    }
+  }
+  for (const Key &key : std::as_const(keys)) {
+    remove(key);
+  }
+  scheduleExpiry();
+  return keys.size();
+}
+
+void PermissionStore::insert(const Grant &grant) {
+  m_grants.insert(Key(grant.origin, static_cast<int>(grant.type)), grant);
+  updateRecord(grant);
+}
+
+void PermissionStore::remove(const Key &key) {
+  auto it = m_grants.find(key);
+  if (it == m_grants.end()) {
+    return;
+  }
+  const Grant grant = *it;
+  m_grants.erase(it);
+
+  m_settings->remove(recordKey(grant.origin, key.second));
+  if (m_profile && QWebEnginePermission::isPersistent(grant.type) &&
+      !isHostOnly(grant.origin)) {
+    m_profile->queryPermission(QUrl(grant.origin), grant.type).reset();
+  }
+}
+
+bool PermissionStore::needsRecord(const Grant &grant) const {
+  return !m_profile || !QWebEnginePermission::isPersistent(grant.type) ||
+         grant.expires.isValid() || isHostOnly(grant.origin);
+}
+
+void PermissionStore::updateRecord(const Grant &grant) {
+  const QString key = recordKey(grant.origin, static_cast<int>(grant.type));
+  if (needsRecord(grant)) {
+    m_settings->setValue(key, grant.expires.isValid()
+                                  ? grant.expires.toString(Qt::ISODateWithMs)
+                                  : QString());
+  } else {
+    m_settings->remove(key);
+  }
+}
+
+void PermissionStore::scheduleExpiry() {
+  QDateTime next;
+  for (const Grant &grant : std::as_const(m_grants)) {
+    if (grant.expires.isValid() && (!next.isValid() || grant.expires < next)) {
+      next = grant.expires;
+    }
+  }
+  if (!next.isValid()) {
+    m_expiryTimer.stop();
+    return;
+  }
+  const qint64 waitMs = std::clamp(
+      QDateTime::currentDateTimeUtc().msecsTo(next), qint64(0),
+      maxExpiryWaitMs);
+  m_expiryTimer.start(static_cast<int>(waitMs));
+}
@@ -0,0 +1,105 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef PERMISSIONSTORE_H
+#define PERMISSIONSTORE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <QWebEnginePermission>
+
+#include <utility>
+
+class QWebEngineProfile;
+class SettingsStore;
+
+// The permissions a profile's user granted, indexed by origin and type so a
+// request that was granted before is answered from memory.
+//
+// With StoreOnDisk, Chromium remembers the types it considers persistent
+// (notifications, geolocation, ...) itself, and doesn't ask again. Those are
+// only indexed here, and recorded in settings.ini only when they expire.
+// The others (camera, microphone, screen capture, ...) are asked for on
+// every page load, and remembered in settings.ini.
+//
+// Older versions remembered grants by host alone. Those are kept as they
+// were, covering every scheme and port of the host, until they are revoked.
+class PermissionStore : public QObject {
+  Q_OBJECT
+
+public:
+  struct Grant {
+    // originKey() of the origin, or just the host for a grant of an older
+    // version
+    QString origin;
+    QWebEnginePermission::PermissionType type;
+    // Invalid if the grant doesn't expire
+    QDateTime expires;
+
+    bool isExpired(const QDateTime &now) const {
+      return expires.isValid() && expires <= now;
+    }
+  };
+
+  // The store of profile, attached to it on first use
+  static PermissionStore *forProfile(QWebEngineProfile *profile);
+
+  explicit PermissionStore(SettingsStore *settings, QObject *parent = nullptr);
+
+  // Hands the grants Chromium keeps to it, and indexes the ones it already
+  // has. Grants and revocations of persistent types are passed on from then.
+  void attach(QWebEngineProfile *profile);
+
+  // "scheme://host[:port]", the index key of origin
+  static QString originKey(const QUrl &origin);
+
+  bool isGranted(const QUrl &origin,
+                 QWebEnginePermission::PermissionType type);
+
+  // Remembers a grant until expires, or for good
+  void grant(const QUrl &origin, QWebEnginePermission::PermissionType type,
+             const QDateTime &expires = QDateTime());
+
+  // Revoking also revokes the grant of an older version for the origin's
+  // host, which would grant it again otherwise
+  void revoke(const QUrl &origin, QWebEnginePermission::PermissionType type);
+  // Revokes everything granted to origin, returns how many grants that was
+  int revokeOrigin(const QUrl &origin);
+
+  // Grants that have not expired, sorted by origin and type
+  QList<Grant> grants() const;
+  // Also lists the grants of an older version that cover origin
+  QList<Grant> grantsForOrigin(const QUrl &origin) const;
+
+  // Revokes the grants that have expired, returns how many there were
+  int removeExpired();
+
+private:
+  using Key = std::pair<QString, int>;
+
+  void load();
+  void insert(const Grant &grant);
+  void remove(const Key &key);
+  // Whether settings.ini has to remember the grant, as Chromium won't
+  bool needsRecord(const Grant &grant) const;
+  void updateRecord(const Grant &grant);
+  void scheduleExpiry();
+
+  static QString recordKey(const QString &origin, int type);
+  // Whether a grant's origin is only a host, from an older version
+  static bool isHostOnly(const QString &origin) {
+    return !origin.contains(QLatin1String("://"));
+  }
+
+  SettingsStore *m_settings;
+  QWebEngineProfile *m_profile = nullptr;
+  QHash<Key, Grant> m_grants;
+  QTimer m_expiryTimer;
+};
+
+#endif // PERMISSIONSTORE_H
@@ -0,0 +1,187 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "preconnect.h"
+
+#include "startuptrace.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHostInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTimer>
+#include <QWebEngineProfile>
+#include <QWebEngineScript>
+#include <QWebEngineScriptCollection>
+#include <QWebEngineUrlRequestInterceptor>
+
+// Enough for a typical app's CDNs and API hosts without preconnecting to
+// every tracker it happens to load
+static constexpr int maxOrigins = 16;
+
+static const QString scriptName = QStringLiteral("webappcontainer-preconnect");
+
+// Collects the origins of every request in the order they are first seen
+class OriginRecorder : public QWebEngineUrlRequestInterceptor {
+public:
+  using QWebEngineUrlRequestInterceptor::QWebEngineUrlRequestInterceptor;
+
+  // Called on the GUI thread
+  void interceptRequest(QWebEngineUrlRequestInfo &info) override {
+    if (m_origins.size() >= maxOrigins) {
+      return;
+    }
+
+    QUrl url = info.requestUrl();
+    // Websocket connections are preconnected as their HTTP equivalent
+    if (url.scheme() == "wss") {
+      url.setScheme("https");
+    } else if (url.scheme() == "ws") {
+      url.setScheme("http");
+    } else if (url.scheme() != "https" && url.scheme() != "http") {
+      return;
+    }
+
+    const QString origin = url.adjusted(QUrl::RemovePath | QUrl::RemoveQuery |
+                                        QUrl::RemoveFragment |
+                                        QUrl::RemoveUserInfo)
+                               .toString();
+    if (!m_origins.contains(origin)) {
+      m_origins.append(origin);
+    }
+  }
+
+  QStringList m_origins;
+};
+
+Preconnect::Preconnect(const QString &profilePath, QObject *parent)
+    : QObject(parent), m_path(profilePath + QDir::separator() +
+                              "preconnect.txt") {
+  QFile file(m_path);
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    while (!file.atEnd() && m_origins.size() < maxOrigins) {
+      const QString origin = QString::fromUtf8(file.readLine()).trimmed();
+      if (!origin.isEmpty()) {
+        m_origins.append(origin);
+      }
+    }
+  }
+}
+
+Preconnect::~Preconnect() {
+  // Keep what was recorded if the app closes within the recording window
+  stopRecording();
+}
+
+void Preconnect::warmUp() {
+  if (m_origins.isEmpty()) {
+    return;
+  }
+  StartupTrace::mark("preconnect", {{"origins", m_origins.size()}});
+
+  // Asynchronous, so an offline resolver waiting out its timeout holds
+  // neither the GUI thread nor the global pool. Chromium resolves names
+  // itself and glibc caches nothing, so this only saves time when a caching
+  // resolver such as systemd-resolved or nscd answers Chromium's lookup. The
+  // preconnect hints are what warm up Chromium's own connections.
+  for (const QString &origin : std::as_const(m_origins)) {
+    const QString host = QUrl(origin).host();
+    QHostInfo::lookupHost(host, this, [host](const QHostInfo &info) {
+      if (info.error() != QHostInfo::NoError) {
+        qDebug() << "Preconnect lookup failed for" << host << ":"
+                 << info.errorString();
+      }
+    });
+  }
+}
+
+void Preconnect::attach(QWebEngineProfile *profile, int recordMs) {
+  m_profile = profile;
+
+  if (!m_origins.isEmpty()) {
+    // The document exists at DocumentCreation but its head doesn't yet, so
+    // the hints go in as soon as the parser creates it
+    static const char source[] = R"(
+(function() {
+  const origins = %1;
+  function addHints() {
+    if (!document.head) {
+      return false;
+    }
+    for (const origin of origins) {
+      for (const rel of ['dns-prefetch', 'preconnect']) {
+        const link = document.createElement('link');
+        link.rel = rel;
+        link.href = origin;
+        document.head.appendChild(link);
+      }
+    }
+    return true;
+  }
+  if (!addHints()) {
+    const observer = new MutationObserver(function() {
+      if (addHints()) {
+        observer.disconnect();
+      }
+    });
+    observer.observe(document, {childList: true, subtree: true});
+  }
+})();
+)";
+
+    QWebEngineScript script;
+    script.setName(scriptName);
+    script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+    script.setWorldId(QWebEngineScript::ApplicationWorld);
+    script.setRunsOnSubFrames(false);
+    script.setSourceCode(
+        QString::fromLatin1(source).arg(QString::fromUtf8(
+            QJsonDocument(QJsonArray::fromStringList(m_origins))
+                .toJson(QJsonDocument::Compact))));
+    profile->scripts()->insert(script);
+  }
+
+  m_recorder = new OriginRecorder(this);
+  profile->setUrlRequestInterceptor(m_recorder);
+  QTimer::singleShot(recordMs, this, &Preconnect::stopRecording);
+}
+
+void Preconnect::removeHints() {
+  if (!m_profile) {
+    return;
+  }
+  const QList<QWebEngineScript> scripts =
+      m_profile->scripts()->find(scriptName);
+  for (const QWebEngineScript &script : scripts) {
+    m_profile->scripts()->remove(script);
+  }
+}
+
+void Preconnect::stopRecording() {
+  if (!m_recorder) {
+    return;
+  }
+
+  if (m_profile) {
+    m_profile->setUrlRequestInterceptor(nullptr);
+  }
+  const QStringList origins = m_recorder->m_origins;
+  delete m_recorder;
+  m_recorder = nullptr;
+
+  // A session that never got online would wipe what was learned
+  if (origins.isEmpty()) {
+    return;
+  }
+
+  qDebug() << "Recorded" << origins.size() << "origins for preconnect";
+  QSaveFile file(m_path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    return;
+  }
+  file.write(origins.join('\n').toUtf8() + '\n');
+  file.commit();
+}
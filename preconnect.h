@@ -0,0 +1,49 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef PRECONNECT_H
+#define PRECONNECT_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+
+class QWebEngineProfile;
+class OriginRecorder;
+
+// Learns which origins (CDNs, API hosts, websocket endpoints) a profile's
+// start page contacts in its first seconds, and warms them up on the next
+// launch before the page asks for them: the start page gets preconnect hints
+// as soon as its document exists, and the hosts are looked up while the
+// profile and window are created.
+class Preconnect : public QObject {
+  Q_OBJECT
+
+public:
+  explicit Preconnect(const QString &profilePath, QObject *parent = nullptr);
+  ~Preconnect();
+
+  // Looks up the hosts learned last time. Call as early as possible.
+  void warmUp();
+
+  // Adds preconnect hints for the learned origins to the profile's pages and
+  // records the origins contacted during the next recordMs
+  void attach(QWebEngineProfile *profile, int recordMs = 10000);
+
+  // Stops adding the hints. They are for the start page, call this once it
+  // has loaded so later pages and popups don't get them.
+  void removeHints();
+
+  const QStringList &origins() const { return m_origins; }
+
+private:
+  void stopRecording();
+
+  QString m_path;
+  QStringList m_origins;
+  QPointer<QWebEngineProfile> m_profile;
+  OriginRecorder *m_recorder = nullptr;
+};
+
+#endif // PRECONNECT_H
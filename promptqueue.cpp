@@ -0,0 +1,113 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "promptqueue.h"
+
+#include <QDebug>
+#include <QDialog>
+#include <QMessageBox>
+#include <QWidget>
+
+#include <algorithm>
+
+// How often the event loop is checked while a prompt is open
+static constexpr int latencyIntervalMs = 50;
+
+PromptQueue::PromptQueue(QWidget *widget) : QObject(widget), m_widget(widget) {
+  m_latencyTimer.setTimerType(Qt::PreciseTimer);
+  m_latencyTimer.setInterval(latencyIntervalMs);
+  connect(&m_latencyTimer, &QTimer::timeout, this,
+          &PromptQueue::measureLatency);
+}
+
+PromptQueue::~PromptQueue() {
+  m_prompts.clear();
+  if (m_dialog) {
+    disconnect(m_dialog, nullptr, this, nullptr);
+    delete m_dialog;
+  }
+}
+
+void PromptQueue::ask(const QString &key, const DialogFactory &createDialog,
+                      const Callback &done) {
+  for (Prompt &prompt : m_prompts) {
+    if (prompt.key == key) {
+      prompt.callbacks.append(done);
+      return;
+    }
+  }
+
+  m_prompts.append({key, createDialog, {done}});
+  if (m_prompts.size() == 1) {
+    showNext();
+  }
+}
+
+void PromptQueue::question(const QString &key, const QString &title,
+                           const QString &text, const Callback &done) {
+  ask(
+      key,
+      [title, text](QWidget *parent) {
+        return new QMessageBox(QMessageBox::Question, title, text,
+                               QMessageBox::Yes | QMessageBox::No, parent);
+      },
+      done);
+}
+
+bool PromptQueue::contains(const QString &key) const {
+  for (const Prompt &prompt : m_prompts) {
+    if (prompt.key == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PromptQueue::showNext() {
+  if (m_prompts.isEmpty()) {
+    m_latencyTimer.stop();
+    return;
+  }
+
+  QDialog *dialog = m_prompts.first().createDialog(m_widget->window());
+  dialog->setWindowFlags(dialog->windowFlags() &
+                         ~Qt::WindowContextHelpButtonHint);
+  dialog->setWindowModality(Qt::WindowModal);
+  connect(dialog, &QDialog::finished, this, &PromptQueue::finish);
+  m_dialog = dialog;
+  dialog->open();
+
+  if (!m_latencyTimer.isActive()) {
+    m_latencyClock.start();
+    m_latencyTimer.start();
+  }
+}
+
+void PromptQueue::finish() {
+  QDialog *dialog = m_dialog;
+  if (!dialog || m_prompts.isEmpty()) {
+    return;
+  }
+  m_dialog = nullptr;
+  dialog->deleteLater();
+
+  bool accepted = dialog->result() == QDialog::Accepted;
+  if (auto *box = qobject_cast<QMessageBox *>(dialog)) {
+    accepted = box->clickedButton() == box->button(QMessageBox::Yes);
+  }
+
+  // A callback may ask again, that goes to the back of the queue
+  const Prompt prompt = m_prompts.takeFirst();
+  for (const Callback &done : prompt.callbacks) {
+    done(accepted);
+  }
+
+  qDebug() << "Prompt answered, event loop latency up to" << m_maxLatencyMs
+           << "ms";
+  showNext();
+}
+
+void PromptQueue::measureLatency() {
+  const qint64 latencyMs = m_latencyClock.restart() - latencyIntervalMs;
+  m_maxLatencyMs = std::max(m_maxLatencyMs, latencyMs);
+}
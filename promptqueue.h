@@ -0,0 +1,76 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef PROMPTQUEUE_H
+#define PROMPTQUEUE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+class QDialog;
+class QWidget;
+
+// Asks the user one question at a time, in window-modal dialogs that don't
+// block the event loop, so pages, notifications, downloads and other windows
+// keep running while a prompt is open. Requests that are the same as one
+// already waiting are answered with it instead of asking twice.
+//
+// The callbacks of prompts that are still open when the queue is destroyed
+// are not called.
+class PromptQueue : public QObject {
+  Q_OBJECT
+
+public:
+  using Callback = std::function<void(bool accepted)>;
+  using DialogFactory = std::function<QDialog *(QWidget *parent)>;
+
+  // Dialogs are shown over widget's window
+  explicit PromptQueue(QWidget *widget);
+  ~PromptQueue();
+
+  // Shows the dialog createDialog makes once the prompts before it are
+  // answered, and calls done with the answer. key identifies the request,
+  // e.g. its origin and type.
+  void ask(const QString &key, const DialogFactory &createDialog,
+           const Callback &done);
+
+  // Asks a Yes/No question
+  void question(const QString &key, const QString &title, const QString &text,
+                const Callback &done);
+
+  bool contains(const QString &key) const;
+  // Prompts shown or waiting
+  int size() const { return m_prompts.size(); }
+  QDialog *currentDialog() const { return m_dialog; }
+
+  // Longest time an event waited for the event loop while a prompt was open
+  qint64 maxEventLoopLatencyMs() const { return m_maxLatencyMs; }
+
+private:
+  struct Prompt {
+    QString key;
+    DialogFactory createDialog;
+    QList<Callback> callbacks;
+  };
+
+  void showNext();
+  void finish();
+  void measureLatency();
+
+  QWidget *m_widget;
+  // The first one is shown
+  QList<Prompt> m_prompts;
+  QPointer<QDialog> m_dialog;
+
+  QTimer m_latencyTimer;
+  QElapsedTimer m_latencyClock;
+  qint64 m_maxLatencyMs = 0;
+};
+
+#endif // PROMPTQUEUE_H
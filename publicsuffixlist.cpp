@@ -2,20 +2,207 @@
 // SPDX - License - Identifier : GPL-2.0-or-later
 
 #include "publicsuffixlist.h"
+#include <QCoreApplication>
 #include <QDebug>
-#include <QFile>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QPromise>
+#include <QStandardPaths>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QTimer>
 
-PublicSuffixList *PublicSuffixList::s_instance = nullptr;
+#include <algorithm>
+#include <iterator>
+
+#ifdef PSL_COMPILED_TABLE
+#include "publicsuffixlist_data.h"
+#endif
+
+std::atomic<PublicSuffixList *> PublicSuffixList::s_instance{nullptr};
+QFuture<void> PublicSuffixList::s_loading;
+QMutex PublicSuffixList::s_mutex;
 
 PublicSuffixList *PublicSuffixList::instance() {
-  if (!s_instance) {
-    s_instance = new PublicSuffixList();
+  if (PublicSuffixList *list = s_instance.load(std::memory_order_acquire)) {
+    return list;
+  }
+
+  QMutexLocker locker(&s_mutex);
+
+  // Block until a pending background load is done rather than racing it
+  if (s_loading.isValid()) {
+    QFuture<void> loading = s_loading;
+    locker.unlock();
+    loading.waitForFinished();
+    return s_instance.load(std::memory_order_acquire);
+  }
+
+  if (!s_instance.load(std::memory_order_relaxed)) {
+    s_instance.store(create(), std::memory_order_release);
+  }
+  return s_instance.load(std::memory_order_relaxed);
+}
+
+QFuture<void> PublicSuffixList::loadAsync() {
+  QMutexLocker locker(&s_mutex);
+  if (s_loading.isValid()) {
+    return s_loading;
+  }
+
+  auto promise = std::make_shared<QPromise<void>>();
+  s_loading = promise->future();
+  promise->start();
+
+  // Already loaded synchronously by an earlier instance() call
+  if (s_instance.load(std::memory_order_acquire)) {
+    promise->finish();
+    return s_loading;
+  }
+
+  QThreadPool::globalInstance()->start([promise]() {
+    s_instance.store(create(), std::memory_order_release);
+    promise->finish();
+  });
+
+  return s_loading;
+}
+
+bool PublicSuffixList::isReady() {
+  return s_instance.load(std::memory_order_acquire) != nullptr;
+}
+
+PublicSuffixList *PublicSuffixList::create() {
+  QElapsedTimer timer;
+  timer.start();
+
+  PublicSuffixList *list = new PublicSuffixList();
+
+  // Runs on a worker thread, so this can't go in the startup trace. qInfo
+  // keeps it in release builds, which compile qDebug out.
+  qInfo() << "Public suffix list ready in" << timer.nsecsElapsed() / 1000
+          << "us";
+  return list;
+}
+
+PublicSuffixList::PublicSuffixList() {
+#ifdef PSL_COMPILED_TABLE
+  // The table was compiled into the binary, there is nothing to load
+  auto compiled = std::make_unique<LoadedTable>();
+  compiled->table = psl::Table{
+      psl::generated::nodes,
+      static_cast<std::uint32_t>(std::size(psl::generated::nodes)),
+      psl::generated::labels,
+      static_cast<std::uint32_t>(std::size(psl::generated::labels) - 1)};
+  compiled->listVersion = psl::generated::listVersion;
+  publish(std::move(compiled));
+#endif
+
+  // A newer list from update-psl takes precedence over the embedded one
+  if (loadSnapshot(snapshotPath())) {
+    return;
   }
-  return s_instance;
+
+  const LoadedTable *current = m_current.load(std::memory_order_acquire);
+  if (!current || !current->table.isValid()) {
+    load();
+  }
+}
+
+// Callers hold m_reloadMutex, except the constructor, which runs before the
+// instance is visible to other threads
+void PublicSuffixList::publish(std::unique_ptr<LoadedTable> table) {
+  const LoadedTable *published = table.get();
+  m_tables.push_back(std::move(table));
+  m_current.store(published, std::memory_order_release);
+}
+
+QString PublicSuffixList::snapshotPath() {
+  return QStandardPaths::writableLocation(
+             QStandardPaths::GenericCacheLocation) +
+         "/webappcontainer/public_suffix_list.bin";
 }
 
-PublicSuffixList::PublicSuffixList() { load(); }
+void PublicSuffixList::watchSnapshot() {
+  const QString path = snapshotPath();
+  const QString directory = QFileInfo(path).absolutePath();
+
+  // Watch the directory as well, update-psl replaces the file by renaming a
+  // new one over it
+  QDir().mkpath(directory);
+  QFileSystemWatcher *watcher =
+      new QFileSystemWatcher(QCoreApplication::instance());
+  watcher->addPath(directory);
+  if (QFileInfo::exists(path)) {
+    watcher->addPath(path);
+  }
+
+  // Coalesce the burst of change notifications a rename produces
+  QTimer *reloadTimer = new QTimer(watcher);
+  reloadTimer->setSingleShot(true);
+  reloadTimer->setInterval(500);
+
+  QObject::connect(watcher, &QFileSystemWatcher::directoryChanged,
+                   reloadTimer, qOverload<>(&QTimer::start));
+  QObject::connect(watcher, &QFileSystemWatcher::fileChanged, reloadTimer,
+                   qOverload<>(&QTimer::start));
+  QObject::connect(reloadTimer, &QTimer::timeout, watcher, [watcher, path]() {
+    const QFileInfo info(path);
+    if (!info.exists()) {
+      return;
+    }
+    // A renamed file is a new inode, so it has to be watched again
+    if (!watcher->files().contains(path)) {
+      watcher->addPath(path);
+    }
+
+    PublicSuffixList *list = instance();
+    const LoadedTable *current =
+        list->m_current.load(std::memory_order_acquire);
+    if (!current || info.lastModified() != current->snapshotModified) {
+      list->loadSnapshot(path);
+    }
+  });
+}
+
+bool PublicSuffixList::loadSnapshot(const QString &path) {
+  auto file = std::make_unique<QFile>(path);
+  if (!file->open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  // The mapping stays valid after the file is replaced on disk, and lives as
+  // long as the QFile does
+  const uchar *data = file->map(0, file->size());
+  std::string_view version;
+  const psl::Table table =
+      psl::readSnapshot(data, data ? std::size_t(file->size()) : 0, &version);
+  if (!table.isValid()) {
+    qWarning() << "Ignoring corrupt public suffix list snapshot:" << path;
+    return false;
+  }
+
+  auto loaded = std::make_unique<LoadedTable>();
+  loaded->table = table;
+  loaded->listVersion = QByteArray(version.data(), qsizetype(version.size()));
+  loaded->snapshotModified = QFileInfo(*file).lastModified();
+  loaded->snapshot = std::move(file);
+
+  QMutexLocker locker(&m_reloadMutex);
+  const LoadedTable *current = m_current.load(std::memory_order_acquire);
+  if (current && loaded->listVersion < current->listVersion) {
+    qDebug() << "Ignoring public suffix list snapshot" << loaded->listVersion
+             << "older than current list" << current->listVersion;
+    return false;
+  }
+
+  qDebug() << "Using public suffix list snapshot" << loaded->listVersion
+           << "from" << path;
+  publish(std::move(loaded));
+  return true;
+}
 
 void PublicSuffixList::load() {
   // Try to load from resources first, then from file
@@ -29,6 +216,10 @@ void PublicSuffixList::load() {
     }
   }
 
+  auto loaded = std::make_unique<LoadedTable>();
+  loaded->parsed = std::make_unique<psl::TableBuilder>();
+  int ruleCount = 0;
+
   QTextStream in(&file);
   while (!in.atEnd()) {
     QString line = in.readLine().trimmed();
@@ -38,78 +229,141 @@ void PublicSuffixList::load() {
       continue;
     }
 
-    // Handle exception rules (start with !)
-    if (line.startsWith("!")) {
-      m_exceptions.insert(line.mid(1).toLower());
-    }
-    // Handle wildcard rules (start with *)
-    else if (line.startsWith("*.")) {
-      m_wildcards.insert(line.mid(2).toLower());
-    }
-    // Normal rules
-    else {
-      m_suffixes.insert(line.toLower());
-    }
+    // Exception ("!www.ck"), wildcard ("*.ck") and normal rules are told
+    // apart by the builder
+    const QString rule = line.toLower();
+    const QStringView view(rule);
+    loaded->parsed->addRule(std::u16string_view(view.utf16(), view.size()));
+    ++ruleCount;
   }
 
   file.close();
-  qDebug() << "Loaded public suffix list:" << m_suffixes.size() << "suffixes,"
-           << m_wildcards.size() << "wildcards," << m_exceptions.size()
-           << "exceptions";
+  loaded->table = loaded->parsed->build();
+  qDebug() << "Loaded public suffix list:" << ruleCount << "rules,"
+           << loaded->table.nodeCount << "nodes";
+
+  QMutexLocker locker(&m_reloadMutex);
+  publish(std::move(loaded));
 }
 
-QString PublicSuffixList::getBaseDomain(const QString &host) const {
-  QString hostname = host.toLower();
-  QStringList parts = hostname.split('.');
+// Returns the start of the label that ends at end (exclusive)
+static qsizetype labelStart(QStringView host, qsizetype end) {
+  qsizetype start = end;
+  while (start > 0 && host[start - 1] != u'.') {
+    --start;
+  }
+  return start;
+}
 
-  if (parts.size() < 2) {
-    return hostname;
+// Compares a rule label with a host label, lowercasing the host label
+static int compareLabel(std::u16string_view rule, QStringView label) {
+  const qsizetype length =
+      std::min<qsizetype>(static_cast<qsizetype>(rule.size()), label.size());
+  for (qsizetype i = 0; i < length; ++i) {
+    char16_t c = label[i].unicode();
+    if (c < 0x80) {
+      if (c >= u'A' && c <= u'Z') {
+        c += u'a' - u'A';
+      }
+    } else if (!QChar::isSurrogate(c)) {
+      c = static_cast<char16_t>(QChar::toLower(char32_t(c)));
+    }
+    if (rule[i] != c) {
+      return rule[i] < c ? -1 : 1;
+    }
   }
+  if (static_cast<qsizetype>(rule.size()) == label.size()) {
+    return 0;
+  }
+  return static_cast<qsizetype>(rule.size()) < label.size() ? -1 : 1;
+}
+
+static const psl::Node *findChild(const psl::Table &table,
+                                  const psl::Node &parent, QStringView label) {
+  const psl::Node *begin = table.nodes + parent.firstChild;
+  const psl::Node *end = begin + parent.childCount;
+  const psl::Node *it = std::lower_bound(
+      begin, end, label, [&table](const psl::Node &node, QStringView label) {
+        return compareLabel(table.label(node), label) < 0;
+      });
+  if (it != end && compareLabel(table.label(*it), label) == 0) {
+    return it;
+  }
+  return nullptr;
+}
 
-  // Find the longest matching suffix
-  int suffixLength = 0;
+static int suffixLength(const psl::Table &table, QStringView host) {
+  if (!table.isValid()) {
+    return 0;
+  }
 
-  for (int i = 0; i < parts.size(); ++i) {
-    QString candidate = parts.mid(i).join('.');
-    QString wildcardCandidate = parts.mid(i + 1).join('.');
+  // Walk the trie from the rightmost label. The deepest matching rule wins;
+  // at equal depth exceptions take priority over normal and wildcard rules.
+  const psl::Node *node = table.nodes;
+  int length = 0;
+  qsizetype end = host.size();
 
-    // Check for exception rules first (they take priority)
-    if (m_exceptions.contains(candidate)) {
-      // Exception found - the suffix is everything after the first part of the
-      // exception
-      suffixLength = parts.size() - i - 1;
-      break;
-    }
+  for (int depth = 1; end >= 0; ++depth) {
+    const qsizetype start = labelStart(host, end);
 
-    // Check for exact match
-    if (m_suffixes.contains(candidate)) {
-      suffixLength = parts.size() - i;
-      break;
+    // A wildcard on the parent matches any label at this depth
+    const bool wildcard = node->flags & psl::Wildcard;
+    const psl::Node *child =
+        findChild(table, *node, host.sliced(start, end - start));
+
+    if (child && (child->flags & psl::Exception)) {
+      // The suffix is everything after the first part of the exception
+      length = depth - 1;
+    } else if (child && (child->flags & psl::Rule)) {
+      length = depth;
+    } else if (wildcard) {
+      length = depth;
     }
 
-    // Check for wildcard match
-    if (m_wildcards.contains(wildcardCandidate)) {
-      suffixLength = parts.size() - i;
+    if (!child) {
       break;
     }
+    node = child;
+    end = start - 1;
   }
 
+  return length;
+}
+
+qsizetype PublicSuffixList::baseDomainOffset(QStringView host) const {
+  // Single label hosts are their own base domain
+  if (!host.contains(u'.')) {
+    return 0;
+  }
+
+  // Find the longest matching suffix. The table is loaded once, so a
+  // concurrent reload can't change it halfway through the walk.
+  const LoadedTable *current = m_current.load(std::memory_order_acquire);
+  int suffixLength = current ? ::suffixLength(current->table, host) : 0;
+
   // Default to 1 if no suffix found (treat last part as TLD)
   if (suffixLength == 0) {
     suffixLength = 1;
   }
 
-  // Base domain is suffix + 1 part (the registered domain)
-  int baseDomainParts = suffixLength + 1;
-
-  if (baseDomainParts > parts.size()) {
-    return hostname;
+  // Base domain is suffix + 1 part (the registered domain). If the host has
+  // fewer labels than that, the whole host is returned.
+  qsizetype start = host.size() + 1;
+  for (int i = 0; i <= suffixLength; ++i) {
+    if (start == 0) {
+      return 0;
+    }
+    start = labelStart(host, start - 1);
   }
+  return start;
+}
 
-  return parts.mid(parts.size() - baseDomainParts).join('.');
+QString PublicSuffixList::getBaseDomain(const QString &host) const {
+  return baseDomain(host).toString().toLower();
 }
 
-bool PublicSuffixList::isSameDomain(const QString &host1,
-                                    const QString &host2) const {
-  return getBaseDomain(host1) == getBaseDomain(host2);
+bool PublicSuffixList::isSameDomain(QStringView host1,
+                                    QStringView host2) const {
+  return baseDomain(host1).compare(baseDomain(host2), Qt::CaseInsensitive) ==
+         0;
 }
@@ -4,25 +4,88 @@
 #ifndef PUBLICSUFFIXLIST_H
 #define PUBLICSUFFIXLIST_H
 
-#include <QSet>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QFuture>
+#include <QMutex>
 #include <QString>
+#include <QStringView>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "publicsuffixtable.h"
+
+// Lookups are safe from any thread, including QtWebEngine request
+// interceptor and cookie filter callbacks. Tables are immutable once
+// published, so readers never take a lock; a reload builds a complete new
+// table and swaps it in atomically.
 class PublicSuffixList {
 public:
+  // Returns the list, loading it on the calling thread if needed. A call that
+  // arrives while loadAsync() is still running waits for that load instead
+  // of starting a second one.
   static PublicSuffixList *instance();
 
+  // Loads the list on a worker thread so the first lookup doesn't pay for it.
+  // Calling it again returns the same future.
+  static QFuture<void> loadAsync();
+  static bool isReady();
+
+  // A binary snapshot in a shared cache location, written by
+  // "make update-psl". Every instance maps it read-only, so they share the
+  // same physical pages. It is used instead of the embedded list unless it is
+  // missing, corrupt or older than the embedded list.
+  static QString snapshotPath();
+
+  // Reloads the snapshot whenever it is replaced. Call on the GUI thread.
+  static void watchSnapshot();
+
+  // Maps the snapshot at path and swaps it in. Returns false, and keeps the
+  // current table, if the file can't be used.
+  bool loadSnapshot(const QString &path);
+
+  // Offset into host at which its registrable domain (public suffix plus one
+  // label) starts. Lookups don't allocate; labels are matched as views and
+  // ASCII case is ignored.
+  qsizetype baseDomainOffset(QStringView host) const;
+  QStringView baseDomain(QStringView host) const {
+    return host.sliced(baseDomainOffset(host));
+  }
+
   QString getBaseDomain(const QString &host) const;
-  bool isSameDomain(const QString &host1, const QString &host2) const;
+  bool isSameDomain(QStringView host1, QStringView host2) const;
 
 private:
+  // A fully built table: either the one compiled in at build time, one mapped
+  // from the shared snapshot, or one parsed from the text list when no
+  // compiled table is available
+  struct LoadedTable {
+    psl::Table table;
+    QByteArray listVersion;
+    std::unique_ptr<psl::TableBuilder> parsed;
+    std::unique_ptr<QFile> snapshot;
+    QDateTime snapshotModified;
+  };
+
   PublicSuffixList();
+  static PublicSuffixList *create();
   void load();
+  void publish(std::unique_ptr<LoadedTable> table);
+
+  static std::atomic<PublicSuffixList *> s_instance;
+  static QFuture<void> s_loading;
+  static QMutex s_mutex;
 
-  static PublicSuffixList *s_instance;
+  std::atomic<const LoadedTable *> m_current{nullptr};
 
-  QSet<QString> m_suffixes;   // Normal rules (e.g., "com.au")
-  QSet<QString> m_wildcards;  // Wildcard rules (e.g., "*.uk")
-  QSet<QString> m_exceptions; // Exception rules (e.g., "!www.ck")
+  // Every table ever published. A lookup on another thread may still be
+  // walking a replaced table, and reloads only happen when update-psl runs,
+  // so replaced tables are kept rather than reclaimed.
+  std::vector<std::unique_ptr<LoadedTable>> m_tables;
+  QMutex m_reloadMutex;
 };
 
 #endif // PUBLICSUFFIXLIST_H
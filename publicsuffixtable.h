@@ -0,0 +1,265 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef PUBLICSUFFIXTABLE_H
+#define PUBLICSUFFIXTABLE_H
+
+// Label trie for the Public Suffix List. This header is shared by the
+// application and the build-time pslcompiler tool, so it must not use Qt.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace psl {
+
+enum NodeFlag : std::uint8_t {
+  Rule = 0x1,      // "com.au" is stored on the "com.au" node
+  Wildcard = 0x2,  // "*.ck" is stored on the "ck" node
+  Exception = 0x4, // "!www.ck" is stored on the "www.ck" node
+};
+
+// Children of a node are stored contiguously and sorted by label (UTF-16 code
+// unit order), so a lookup is one binary search per host label.
+struct Node {
+  std::uint32_t labelOffset;
+  std::uint32_t firstChild;
+  std::uint16_t childCount;
+  std::uint8_t labelLength;
+  std::uint8_t flags;
+};
+
+struct Table {
+  const Node *nodes = nullptr; // nodes[0] is the root
+  std::uint32_t nodeCount = 0;
+  const char16_t *labels = nullptr;
+  std::uint32_t labelsSize = 0;
+
+  bool isValid() const { return nodes && nodeCount > 0; }
+
+  std::u16string_view label(const Node &node) const {
+    return std::u16string_view(labels + node.labelOffset, node.labelLength);
+  }
+};
+
+// Binary snapshot of a Table that can be mapped read-only and shared between
+// processes: a SnapshotHeader followed by the nodes and the label pool, in
+// native byte order.
+inline constexpr char snapshotMagic[8] = {'W', 'A', 'C', 'P', 'S', 'L', 0, 0};
+inline constexpr std::uint32_t snapshotVersion = 1;
+
+struct SnapshotHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t nodeCount;
+  std::uint32_t labelsSize;
+  std::uint32_t checksum;
+  char listVersion[32]; // "VERSION:" line of the list, NUL padded
+};
+
+// FNV-1a, enough to catch truncated or scribbled snapshots
+inline std::uint32_t checksum(const void *data, std::size_t size,
+                              std::uint32_t hash = 2166136261u) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+inline std::string writeSnapshot(const Table &table,
+                                 std::string_view listVersion) {
+  SnapshotHeader header{};
+  std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+  header.version = snapshotVersion;
+  header.nodeCount = table.nodeCount;
+  header.labelsSize = table.labelsSize;
+  std::memcpy(header.listVersion, listVersion.data(),
+              std::min(listVersion.size(), sizeof(header.listVersion) - 1));
+
+  const std::size_t nodesSize = sizeof(Node) * table.nodeCount;
+  const std::size_t labelsSize = sizeof(char16_t) * table.labelsSize;
+  header.checksum = checksum(table.labels, labelsSize,
+                             checksum(table.nodes, nodesSize));
+
+  std::string data;
+  data.reserve(sizeof(header) + nodesSize + labelsSize);
+  data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+  data.append(reinterpret_cast<const char *>(table.nodes), nodesSize);
+  data.append(reinterpret_cast<const char *>(table.labels), labelsSize);
+  return data;
+}
+
+// Validates a snapshot and returns a Table pointing into data, or an invalid
+// Table if the snapshot is truncated, corrupt or from another version. Every
+// index is bounds checked, so a bad file can't make lookups read out of range.
+inline Table readSnapshot(const void *data, std::size_t size,
+                          std::string_view *listVersion = nullptr) {
+  if (!data || size < sizeof(SnapshotHeader)) {
+    return Table();
+  }
+
+  SnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 ||
+      header.version != snapshotVersion || header.nodeCount == 0) {
+    return Table();
+  }
+
+  const std::size_t nodesSize = sizeof(Node) * std::size_t(header.nodeCount);
+  const std::size_t labelsSize =
+      sizeof(char16_t) * std::size_t(header.labelsSize);
+  if (size != sizeof(header) + nodesSize + labelsSize) {
+    return Table();
+  }
+
+  const char *bytes = static_cast<const char *>(data);
+  Table table{reinterpret_cast<const Node *>(bytes + sizeof(header)),
+              header.nodeCount,
+              reinterpret_cast<const char16_t *>(bytes + sizeof(header) +
+                                                 nodesSize),
+              header.labelsSize};
+  if (checksum(table.labels, labelsSize, checksum(table.nodes, nodesSize)) !=
+      header.checksum) {
+    return Table();
+  }
+
+  for (std::uint32_t i = 0; i < table.nodeCount; ++i) {
+    const Node &node = table.nodes[i];
+    if (std::size_t(node.labelOffset) + node.labelLength > table.labelsSize) {
+      return Table();
+    }
+    // Children always come after their parent, so walks terminate
+    if (node.childCount > 0 &&
+        (node.firstChild <= i ||
+         std::size_t(node.firstChild) + node.childCount > table.nodeCount)) {
+      return Table();
+    }
+  }
+
+  if (listVersion) {
+    const char *end = std::find(std::begin(header.listVersion),
+                                std::end(header.listVersion), '\0');
+    const std::size_t length = end - header.listVersion;
+    // The header was copied, so point back into data
+    *listVersion = std::string_view(
+        bytes + offsetof(SnapshotHeader, listVersion), length);
+  }
+  return table;
+}
+
+// Builds a Table from individual rules. Used by pslcompiler to generate the
+// embedded table and by the application when it has to parse the text list.
+class TableBuilder {
+public:
+  TableBuilder() : m_tree(1) {}
+
+  // Adds one rule as written in the list, e.g. "com.au", "*.ck" or "!www.ck".
+  // The rule must already be lowercase.
+  void addRule(std::u16string_view rule) {
+    std::uint8_t flag = Rule;
+    if (rule.starts_with(u'!')) {
+      flag = Exception;
+      rule.remove_prefix(1);
+    } else if (rule.starts_with(u"*.")) {
+      flag = Wildcard;
+      rule.remove_prefix(2);
+    }
+    if (rule.empty()) {
+      return;
+    }
+
+    // Insert labels right to left, so "com.au" becomes root -> au -> com
+    std::size_t node = 0;
+    std::size_t end = rule.size();
+    while (true) {
+      std::size_t dot = rule.rfind(u'.', end - 1);
+      std::size_t start = dot == std::u16string_view::npos ? 0 : dot + 1;
+      std::u16string label(rule.substr(start, end - start));
+
+      auto it = m_tree[node].children.find(label);
+      if (it == m_tree[node].children.end()) {
+        std::size_t child = m_tree.size();
+        m_tree[node].children.emplace(std::move(label), child);
+        m_tree.emplace_back();
+        node = child;
+      } else {
+        node = it->second;
+      }
+
+      if (dot == std::u16string_view::npos || dot == 0) {
+        break;
+      }
+      end = dot;
+    }
+    m_tree[node].flags |= flag;
+  }
+
+  // Flattens the tree breadth first so that every node's children are
+  // adjacent. The returned Table points into this builder.
+  Table build() {
+    m_nodes.clear();
+    m_labels.clear();
+    std::unordered_map<std::u16string, std::uint32_t> labelOffsets;
+
+    struct Pending {
+      std::size_t tree;
+      std::u16string_view label;
+    };
+    std::vector<Pending> queue{{0, std::u16string_view()}};
+    m_nodes.push_back(Node{0, 0, 0, 0, 0});
+
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      const TreeNode &tree = m_tree[queue[i].tree];
+      Node &node = m_nodes[i];
+      node.flags = tree.flags;
+      node.firstChild = static_cast<std::uint32_t>(queue.size());
+      node.childCount = static_cast<std::uint16_t>(tree.children.size());
+
+      std::u16string_view label = queue[i].label;
+      auto [it, inserted] = labelOffsets.try_emplace(
+          std::u16string(label), static_cast<std::uint32_t>(m_labels.size()));
+      if (inserted) {
+        m_labels.append(label);
+      }
+      node.labelOffset = it->second;
+      node.labelLength = static_cast<std::uint8_t>(label.size());
+
+      for (const auto &[childLabel, child] : tree.children) {
+        queue.push_back({child, childLabel});
+        m_nodes.push_back(Node{0, 0, 0, 0, 0});
+      }
+    }
+
+    return table();
+  }
+
+  Table table() const {
+    return Table{m_nodes.data(), static_cast<std::uint32_t>(m_nodes.size()),
+                 m_labels.data(), static_cast<std::uint32_t>(m_labels.size())};
+  }
+
+  const std::vector<Node> &nodes() const { return m_nodes; }
+  const std::u16string &labels() const { return m_labels; }
+
+private:
+  struct TreeNode {
+    std::uint8_t flags = 0;
+    std::map<std::u16string, std::size_t> children;
+  };
+
+  std::vector<TreeNode> m_tree;
+  std::vector<Node> m_nodes;
+  std::u16string m_labels;
+};
+
+} // namespace psl
+
+#endif // PUBLICSUFFIXTABLE_H
@@ -0,0 +1,347 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "readahead.h"
+#include "startuptrace.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QSaveFile>
+#include <QSocketNotifier>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Enough for the databases and the cache entries of the start page
+static constexpr int maxFiles = 512;
+// inotify watches count against a per-user limit shared with every other
+// program, the cache and storage directories need far fewer
+static constexpr int maxWatches = 256;
+
+#ifdef Q_OS_LINUX
+namespace {
+
+struct FileEntry {
+  QByteArray path;
+  quint64 physical; // byte offset of the first extent on the device
+  quint64 inode;
+  qint64 size;
+};
+
+// Where the file starts on disk, or 0 if the file system can't tell
+quint64 physicalOffset(int fd) {
+  alignas(fiemap) char buffer[sizeof(fiemap) + sizeof(fiemap_extent)] = {};
+  fiemap *map = reinterpret_cast<fiemap *>(buffer);
+  map->fm_length = FIEMAP_MAX_OFFSET;
+  map->fm_extent_count = 1;
+  if (ioctl(fd, FS_IOC_FIEMAP, map) != 0 || map->fm_mapped_extents == 0) {
+    return 0;
+  }
+  return map->fm_extents[0].fe_physical;
+}
+
+Readahead::Result readAhead(const QStringList &paths, qint64 budget,
+                            const std::atomic<bool> &cancelled) {
+  std::vector<FileEntry> entries;
+  entries.reserve(paths.size());
+  for (const QString &path : paths) {
+    const QByteArray local = QFile::encodeName(path);
+    const int fd = ::open(local.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) &&
+        status.st_size > 0) {
+      entries.push_back({local, physicalOffset(fd), quint64(status.st_ino),
+                         qint64(status.st_size)});
+    }
+    ::close(fd);
+  }
+
+  // Disk order, so a rotating disk reads in one sweep. Where the file
+  // system doesn't map extents the inode order is the next best guess.
+  std::sort(entries.begin(), entries.end(),
+            [](const FileEntry &a, const FileEntry &b) {
+              if ((a.physical == 0) != (b.physical == 0)) {
+                return a.physical != 0;
+              }
+              return a.physical != b.physical ? a.physical < b.physical
+                                              : a.inode < b.inode;
+            });
+
+  Readahead::Result result;
+  for (const FileEntry &entry : entries) {
+    if (cancelled.load(std::memory_order_relaxed)) {
+      result.cancelled = true;
+      break;
+    }
+    const qint64 length = std::min(entry.size, budget - result.bytes);
+    if (length <= 0) {
+      break;
+    }
+    const int fd = ::open(entry.path.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+    // Queues the reads and returns, the kernel fills the page cache while
+    // Chromium starts
+    if (posix_fadvise(fd, 0, length, POSIX_FADV_WILLNEED) == 0) {
+      ++result.files;
+      result.bytes += length;
+    }
+    ::close(fd);
+  }
+  return result;
+}
+
+// The files under directory that this process has open, relative to it
+QStringList openFiles(const QString &directory) {
+  QStringList files;
+  const QStringList descriptors =
+      QDir("/proc/self/fd").entryList(QDir::System | QDir::NoDotAndDotDot);
+  char target[4096];
+  for (const QString &descriptor : descriptors) {
+    const QByteArray link = QFile::encodeName("/proc/self/fd/" + descriptor);
+    const ssize_t length = ::readlink(link.constData(), target, sizeof target);
+    if (length <= 0 || length == sizeof target) {
+      continue;
+    }
+    const QString path = QFile::decodeName(QByteArray(target, length));
+    if (path.startsWith(directory) && !path.endsWith(" (deleted)")) {
+      files.append(path.mid(directory.size()));
+    }
+  }
+  return files;
+}
+
+} // namespace
+#endif
+
+Readahead::Readahead(const QString &profilePath, QObject *parent)
+    : QObject(parent), m_profilePath(profilePath),
+      m_listPath(profilePath + QDir::separator() + "readahead.txt") {
+  QFile file(m_listPath);
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    while (!file.atEnd() && m_files.size() < maxFiles) {
+      const QString path = QString::fromUtf8(file.readLine()).trimmed();
+      // Only files inside the profile are read
+      if (!path.isEmpty() && !path.startsWith('/') && !path.contains("..")) {
+        m_files.append(path);
+      }
+    }
+  }
+}
+
+Readahead::~Readahead() {
+  // Keeps what was recorded if the app closes within the recording window
+  cancel();
+  stopRecording();
+  m_reading.waitForFinished();
+}
+
+QFuture<Readahead::Result> Readahead::start(qint64 budget) {
+#ifdef Q_OS_LINUX
+  if (m_files.isEmpty() || m_reading.isValid()) {
+    return m_reading;
+  }
+  StartupTrace::mark("readahead", {{"files", m_files.size()}});
+
+  QStringList paths;
+  for (const QString &file : std::as_const(m_files)) {
+    paths.append(m_profilePath + QDir::separator() + file);
+  }
+
+  m_cancelled = std::make_shared<std::atomic<bool>>(false);
+  auto promise = std::make_shared<QPromise<Result>>();
+  m_reading = promise->future();
+  promise->start();
+
+  QElapsedTimer timer;
+  timer.start();
+  auto *watcher = new QFutureWatcher<Result>(this);
+  connect(watcher, &QFutureWatcher<Result>::finished, this,
+          [this, watcher, timer]() {
+            const Result result = watcher->result();
+            watcher->deleteLater();
+            StartupTrace::mark("readaheadFinished",
+                               {{"files", result.files},
+                                {"bytes", result.bytes},
+                                {"cancelled", result.cancelled}});
+            qDebug() << "Read ahead" << result.files << "files,"
+                     << result.bytes / 1024 << "KiB in" << timer.elapsed()
+                     << "ms" << (result.cancelled ? "(cancelled)" : "");
+            if (m_recordMs > 0) {
+              startRecording();
+            }
+          });
+  watcher->setFuture(m_reading);
+
+  QThreadPool::globalInstance()->start(
+      [promise, paths, budget, cancelled = m_cancelled]() {
+        promise->addResult(readAhead(paths, budget, *cancelled));
+        promise->finish();
+      });
+#else
+  Q_UNUSED(budget);
+#endif
+  return m_reading;
+}
+
+void Readahead::cancel() {
+  if (m_cancelled) {
+    m_cancelled->store(true, std::memory_order_relaxed);
+  }
+}
+
+void Readahead::record(int recordMs) {
+  m_recordMs = recordMs;
+  if (!m_reading.isValid()) {
+    startRecording();
+  }
+}
+
+// Opens are watched with inotify rather than by sampling the descriptors
+// the process holds: nothing polls, no thread waits through startup, and
+// cache entries that are opened and closed again in between are seen too.
+// Events queue in the kernel while the GUI thread is busy.
+void Readahead::startRecording() {
+#ifdef Q_OS_LINUX
+  if (m_inotify >= 0 || m_recordMs <= 0) {
+    return;
+  }
+  m_inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify < 0) {
+    qWarning() << "Can't record the profile's files:" << qt_error_string();
+    return;
+  }
+
+  // The databases Chromium opened already won't be opened again
+  const QStringList open = openFiles(m_profilePath + QDir::separator());
+  for (const QString &file : open) {
+    addRecorded(file);
+  }
+
+  watchDirectory(QString(), false);
+  m_notifier = new QSocketNotifier(m_inotify, QSocketNotifier::Read, this);
+  connect(m_notifier, &QSocketNotifier::activated, this,
+          &Readahead::readEvents);
+
+  QTimer::singleShot(m_recordMs, this, &Readahead::stopRecording);
+#endif
+}
+
+void Readahead::stopRecording() {
+#ifdef Q_OS_LINUX
+  m_recordMs = 0;
+  if (m_inotify < 0) {
+    return;
+  }
+
+  readEvents();
+  delete m_notifier;
+  m_notifier = nullptr;
+  ::close(m_inotify);
+  m_inotify = -1;
+  m_watches.clear();
+
+  // A session that didn't get to open anything would wipe the list
+  if (m_recorded.isEmpty()) {
+    return;
+  }
+  qDebug() << "Recorded" << m_recorded.size() << "files to read ahead";
+  QSaveFile file(m_listPath);
+  if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    file.write(m_recorded.join('\n').toUtf8() + '\n');
+    file.commit();
+  }
+#endif
+}
+
+// inotify doesn't watch subdirectories, each one needs its own watch. Files
+// in a directory that appeared while recording were created, and so opened,
+// before the watch was in place.
+void Readahead::watchDirectory(const QString &relative, bool recordFiles) {
+#ifdef Q_OS_LINUX
+  if (m_watches.size() >= maxWatches) {
+    return;
+  }
+  const QString path = m_profilePath + QDir::separator() + relative;
+  const int watch = ::inotify_add_watch(
+      m_inotify, QFile::encodeName(path).constData(),
+      IN_OPEN | IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+  if (watch < 0) {
+    return;
+  }
+  const QString prefix = relative.isEmpty() ? QString() : relative + '/';
+  m_watches.insert(watch, prefix);
+
+  const QFileInfoList entries =
+      QDir(path).entryInfoList(QDir::AllEntries | QDir::Hidden |
+                               QDir::NoDotAndDotDot | QDir::NoSymLinks);
+  for (const QFileInfo &entry : entries) {
+    if (entry.isDir()) {
+      watchDirectory(prefix + entry.fileName(), recordFiles);
+    } else if (recordFiles) {
+      addRecorded(prefix + entry.fileName());
+    }
+  }
+#else
+  Q_UNUSED(relative);
+  Q_UNUSED(recordFiles);
+#endif
+}
+
+void Readahead::readEvents() {
+#ifdef Q_OS_LINUX
+  alignas(inotify_event) char buffer[16 * 1024];
+  for (;;) {
+    const ssize_t length = ::read(m_inotify, buffer, sizeof buffer);
+    if (length <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < length;) {
+      const char *data = buffer + offset;
+      const auto *event = reinterpret_cast<const inotify_event *>(data);
+      offset += sizeof(inotify_event) + event->len;
+      // Events without a name are about the watched directory itself
+      if (event->len == 0) {
+        continue;
+      }
+      const QString relative =
+          m_watches.value(event->wd) + QFile::decodeName(event->name);
+      if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+          watchDirectory(relative, true);
+        }
+      } else if (event->mask & IN_OPEN) {
+        addRecorded(relative);
+      }
+    }
+  }
+#endif
+}
+
+void Readahead::addRecorded(const QString &relative) {
+  if (m_recorded.size() >= maxFiles || relative == "readahead.txt" ||
+      m_seen.contains(relative)) {
+    return;
+  }
+  m_seen.insert(relative);
+  m_recorded.append(relative);
+}
@@ -0,0 +1,76 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+
+class QSocketNotifier;
+
+// Learns which files of a profile (cookies, local storage, HTTP cache
+// entries) the app opens while it starts, and asks the kernel to read them
+// into the page cache at the next launch, before Chromium gets to them.
+// After a reboot this turns Chromium's scattered reads into one pass in
+// disk order.
+class Readahead : public QObject {
+  Q_OBJECT
+
+public:
+  struct Result {
+    int files = 0;
+    qint64 bytes = 0;
+    bool cancelled = false;
+  };
+
+  explicit Readahead(const QString &profilePath, QObject *parent = nullptr);
+  ~Readahead();
+
+  // Starts reading ahead the files recorded last time on a worker thread,
+  // up to budget bytes. Call before the profile is created.
+  QFuture<Result> start(qint64 budget = 64 * 1024 * 1024);
+
+  // Stops reading ahead after the current file. Pages already requested
+  // are still read by the kernel.
+  void cancel();
+
+  // Records the profile files that are open now or opened during the next
+  // recordMs, by any of the app's processes. Recording waits for the read
+  // ahead, so it doesn't record its own reads.
+  void record(int recordMs = 10000);
+
+  const QStringList &files() const { return m_files; }
+
+private:
+  void startRecording();
+  void stopRecording();
+  void watchDirectory(const QString &relative, bool recordFiles);
+  void readEvents();
+  void addRecorded(const QString &relative);
+
+  QString m_profilePath;
+  QString m_listPath;
+  QStringList m_files;
+  int m_recordMs = 0;
+
+  std::shared_ptr<std::atomic<bool>> m_cancelled;
+  QFuture<Result> m_reading;
+
+  // inotify descriptor and the profile directory, ending in a separator,
+  // each of its watches is on
+  int m_inotify = -1;
+  QSocketNotifier *m_notifier = nullptr;
+  QHash<int, QString> m_watches;
+  QStringList m_recorded;
+  QSet<QString> m_seen;
+};
+
+#endif // READAHEAD_H
@@ -0,0 +1,315 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "settingsstore.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QThreadPool>
+#include <QtEndian>
+
+#include <cstdio>
+
+// Retry interval while the previous write is still running
+static constexpr int busyRetryMs = 50;
+
+// A journal this big is compacted right away
+static constexpr qint64 maxJournalBytes = 64 * 1024;
+
+// Every journal record starts with the size and checksum of its payload, so
+// one that was cut short is found and dropped
+static constexpr int recordHeaderBytes = 6;
+
+// The journal that is being compacted into settings.ini
+static QString compactingJournalName(const QString &journalName) {
+  return journalName + ".old";
+}
+
+SettingsStore *SettingsStore::forProfile(const QString &profilePath) {
+  static QHash<QString, SettingsStore *> stores;
+
+  const QString fileName =
+      QDir::cleanPath(profilePath + QDir::separator() + "settings.ini");
+  SettingsStore *&store = stores[fileName];
+  if (!store) {
+    store = new SettingsStore(fileName, 30000, QCoreApplication::instance());
+    QObject::connect(QCoreApplication::instance(),
+                     &QCoreApplication::aboutToQuit, store,
+                     [store]() { store->flush(); });
+    QObject::connect(store, &QObject::destroyed,
+                     [fileName]() { stores.remove(fileName); });
+  }
+  return store;
+}
+
+SettingsStore::SettingsStore(const QString &fileName, int maxDelayMs,
+                             QObject *parent)
+    : QObject(parent), m_fileName(fileName),
+      m_writes(std::make_shared<std::atomic<int>>(0)) {
+  if (QFileInfo::exists(fileName)) {
+    QSettings settings(fileName, QSettings::IniFormat);
+    const QStringList keys = settings.allKeys();
+    for (const QString &key : keys) {
+      m_values.insert(key, settings.value(key));
+    }
+    ++m_parses;
+  }
+
+  // Not restarted by later changes, so the first change waits at most
+  // maxDelayMs however many follow it
+  m_writeTimer.setSingleShot(true);
+  m_writeTimer.setInterval(maxDelayMs);
+  connect(&m_writeTimer, &QTimer::timeout, this, &SettingsStore::startWrite);
+  m_compactTimer.setSingleShot(true);
+  m_compactTimer.setInterval(0);
+  connect(&m_compactTimer, &QTimer::timeout, this,
+          &SettingsStore::startWrite);
+
+  // Changes a crash kept out of settings.ini, oldest first
+  const QString journalName = fileName + ".journal";
+  replayJournal(compactingJournalName(journalName));
+  const qint64 validSize = replayJournal(journalName);
+
+  m_journal.setFileName(journalName);
+  openJournal();
+  if (m_journal.size() > validSize) {
+    // Appended after a torn record, a change would be lost on replay
+    m_journal.resize(validSize);
+  }
+  if (m_replayed > 0) {
+    scheduleWrite();
+  }
+}
+
+SettingsStore::~SettingsStore() {
+  if (flush() && m_journal.size() == 0) {
+    m_journal.remove();
+  }
+}
+
+QVariant SettingsStore::value(const QString &key,
+                              const QVariant &defaultValue) const {
+  return m_values.value(key, defaultValue);
+}
+
+bool SettingsStore::contains(const QString &key) const {
+  return m_values.contains(key);
+}
+
+QStringList SettingsStore::keys(const QString &prefix) const {
+  QStringList keys;
+  for (auto it = m_values.cbegin(); it != m_values.cend(); ++it) {
+    if (it.key().startsWith(prefix)) {
+      keys.append(it.key());
+    }
+  }
+  keys.sort();
+  return keys;
+}
+
+void SettingsStore::setValue(const QString &key, const QVariant &value) {
+  auto it = m_values.find(key);
+  if (it != m_values.end() && it.value() == value) {
+    return;
+  }
+  m_values.insert(key, value);
+  appendToJournal(SetOp, key, value);
+  scheduleWrite();
+}
+
+void SettingsStore::remove(const QString &key) {
+  if (m_values.remove(key)) {
+    appendToJournal(RemoveOp, key);
+    scheduleWrite();
+  }
+}
+
+void SettingsStore::openJournal() {
+  if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append |
+                      QIODevice::Unbuffered)) {
+    qWarning() << "Could not open" << m_journal.fileName() << ":"
+               << m_journal.errorString();
+  }
+}
+
+void SettingsStore::appendToJournal(JournalOp op, const QString &key,
+                                    const QVariant &value) {
+  if (!m_journal.isOpen()) {
+    return;
+  }
+
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_5);
+  out << quint8(op) << key;
+  if (op == SetOp) {
+    out << value;
+  }
+
+  QByteArray record(recordHeaderBytes, Qt::Uninitialized);
+  qToLittleEndian<quint32>(payload.size(), record.data());
+  qToLittleEndian<quint16>(qChecksum(payload), record.data() + 4);
+  record += payload;
+
+  // One write, the kernel has the record once it returns
+  if (m_journal.write(record) != record.size()) {
+    qWarning() << "Could not append to" << m_journal.fileName() << ":"
+               << m_journal.errorString();
+  }
+
+  if (m_journal.size() > maxJournalBytes) {
+    m_compactTimer.start();
+  }
+}
+
+qint64 SettingsStore::replayJournal(const QString &fileName) {
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return 0;
+  }
+  const QByteArray journal = file.readAll();
+
+  qint64 position = 0;
+  while (journal.size() - position >= recordHeaderBytes) {
+    const char *header = journal.constData() + position;
+    const qint64 size = qFromLittleEndian<quint32>(header);
+    const quint16 checksum = qFromLittleEndian<quint16>(header + 4);
+    if (journal.size() - position - recordHeaderBytes < size) {
+      break;
+    }
+    const QByteArray payload =
+        journal.mid(position + recordHeaderBytes, size);
+    if (qChecksum(payload) != checksum) {
+      break;
+    }
+
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_5);
+    quint8 op = 0;
+    QString key;
+    QVariant value;
+    in >> op >> key;
+    if (op == SetOp) {
+      in >> value;
+    }
+    if (in.status() != QDataStream::Ok || (op != SetOp && op != RemoveOp)) {
+      break;
+    }
+
+    if (op == SetOp) {
+      m_values.insert(key, value);
+    } else {
+      m_values.remove(key);
+    }
+    ++m_replayed;
+    position += recordHeaderBytes + size;
+  }
+
+  if (position < journal.size()) {
+    qWarning() << "Dropped" << journal.size() - position
+               << "bytes of a torn record at the end of" << fileName;
+  }
+  return position;
+}
+
+void SettingsStore::scheduleWrite() {
+  m_dirty = true;
+  if (!m_writeTimer.isActive()) {
+    m_writeTimer.start();
+  }
+}
+
+bool SettingsStore::isWriting() const {
+  return m_writeDone && m_writeDone->available() == 0;
+}
+
+void SettingsStore::startWrite() {
+  if (!m_dirty) {
+    return;
+  }
+  // One write at a time, so they can't land out of order. The retry is a
+  // timer of its own, m_writeTimer keeps maxDelayMs for later changes.
+  if (isWriting()) {
+    QTimer::singleShot(busyRetryMs, this, &SettingsStore::startWrite);
+    return;
+  }
+
+  // Changes from here on wait up to maxDelayMs again
+  m_dirty = false;
+  m_writeTimer.stop();
+  m_writeDone = std::make_shared<QSemaphore>(0);
+
+  // Changes from here on go to a new journal. The old one goes once
+  // settings.ini has them. If a failed write left one behind, it is kept,
+  // and both are replayed after a crash.
+  const QString compacting = compactingJournalName(m_journal.fileName());
+  if (!QFile::exists(compacting)) {
+    m_journal.close();
+    QFile::rename(m_journal.fileName(), compacting);
+    openJournal();
+  }
+
+  // QSettings merges with what is on disk when it syncs, so it writes a new
+  // file that replaces the old one in a single rename
+  QThreadPool::globalInstance()->start(
+      [values = m_values, fileName = m_fileName, compacting,
+       writes = m_writes, done = m_writeDone]() {
+        const QString temporary = fileName + ".new";
+        QFile::remove(temporary);
+        bool written = false;
+        {
+          QSettings settings(temporary, QSettings::IniFormat);
+          for (auto it = values.cbegin(); it != values.cend(); ++it) {
+            settings.setValue(it.key(), it.value());
+          }
+          settings.sync();
+          written = settings.status() == QSettings::NoError;
+          if (!written) {
+            qWarning() << "Could not write settings to" << temporary;
+          }
+        }
+        if (written &&
+            std::rename(QFile::encodeName(temporary).constData(),
+                        QFile::encodeName(fileName).constData()) != 0) {
+          qWarning() << "Could not replace" << fileName;
+          written = false;
+        }
+        if (written) {
+          QFile::remove(compacting);
+        }
+        ++*writes;
+        done->release();
+      });
+}
+
+bool SettingsStore::waitForWrite(QDeadlineTimer deadline) {
+  if (!isWriting()) {
+    return true;
+  }
+  if (!m_writeDone->tryAcquire(1, deadline)) {
+    return false;
+  }
+  m_writeDone->release();
+  return true;
+}
+
+bool SettingsStore::flush(int deadlineMs) {
+  QDeadlineTimer deadline(deadlineMs);
+  m_writeTimer.stop();
+
+  // A write in flight has an older snapshot, the next one follows it
+  if (waitForWrite(deadline)) {
+    startWrite();
+    if (waitForWrite(deadline)) {
+      return true;
+    }
+  }
+  qWarning() << "Settings for" << m_fileName << "not written within"
+             << deadlineMs << "ms";
+  return false;
+}
@@ -0,0 +1,96 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+#include <atomic>
+#include <memory>
+
+// A profile's settings.ini, parsed once and served from memory. The file
+// keeps the QSettings INI format and keys ("BrowserWindow/geometry").
+//
+// Every change is appended to settings.ini.journal right away, one write()
+// per change, so it survives the process being killed. A worker thread
+// compacts the journal into settings.ini at most maxDelayMs after the first
+// change, or sooner once the journal grows, so a burst of changes costs one
+// rewrite. The new file replaces the old one in a single rename, and the
+// journal is replayed over whichever of them a crash left behind.
+//
+// GUI thread only.
+class SettingsStore : public QObject {
+  Q_OBJECT
+
+public:
+  // The store for the settings.ini in profilePath. It lives until the
+  // application exits and is flushed when it is about to quit.
+  static SettingsStore *forProfile(const QString &profilePath);
+
+  explicit SettingsStore(const QString &fileName, int maxDelayMs = 30000,
+                         QObject *parent = nullptr);
+  // Flushes with the default deadline
+  ~SettingsStore();
+
+  QVariant value(const QString &key,
+                 const QVariant &defaultValue = QVariant()) const;
+  bool contains(const QString &key) const;
+  // Keys that start with prefix, all keys if it is empty
+  QStringList keys(const QString &prefix = QString()) const;
+
+  void setValue(const QString &key, const QVariant &value);
+  void remove(const QString &key);
+
+  // Compacts the journal into settings.ini and waits up to deadlineMs for it
+  // to reach the disk. Returns false if it didn't make it in time.
+  bool flush(int deadlineMs = 2000);
+
+  // How often this store parsed and wrote settings.ini. Every write ends
+  // with an fsync.
+  int fileParses() const { return m_parses; }
+  int fileWrites() const { return m_writes->load(); }
+  // Changes read back from the journal on load
+  int journalReplayed() const { return m_replayed; }
+
+  const QString &fileName() const { return m_fileName; }
+
+private:
+  enum JournalOp : quint8 { SetOp = 1, RemoveOp = 2 };
+
+  void openJournal();
+  void appendToJournal(JournalOp op, const QString &key,
+                       const QVariant &value = QVariant());
+  // Applies the changes in a journal, returns the size of its valid part
+  qint64 replayJournal(const QString &fileName);
+
+  void scheduleWrite();
+  void startWrite();
+  bool isWriting() const;
+  bool waitForWrite(QDeadlineTimer deadline);
+
+  QString m_fileName;
+  QHash<QString, QVariant> m_values;
+  bool m_dirty = false;
+  QTimer m_writeTimer;
+  // Compacts a journal that grew past its limit once control returns to the
+  // event loop
+  QTimer m_compactTimer;
+  QFile m_journal;
+  int m_parses = 0;
+  int m_replayed = 0;
+  std::shared_ptr<std::atomic<int>> m_writes;
+
+  // Released by the worker once the write in flight is done
+  std::shared_ptr<QSemaphore> m_writeDone;
+};
+
+#endif // SETTINGSSTORE_H
@@ -0,0 +1,118 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "singleinstance.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+
+// Socket names live in the per-user runtime directory, so different users
+// never see each other's instances
+static QString serverNameForKey(const QString &key) {
+  QString directory =
+      QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+  if (directory.isEmpty()) {
+    directory = QDir::tempPath();
+  }
+  const QByteArray hash =
+      QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1)
+          .toHex()
+          .left(16);
+  return directory + "/webappcontainer-" + QString::fromLatin1(hash) +
+         ".socket";
+}
+
+SingleInstance::SingleInstance(const QString &key, QObject *parent)
+    : QObject(parent), m_serverName(serverNameForKey(key)),
+      m_lock(m_serverName + ".lock") {
+  // The lock is held for as long as the instance runs. Only a lock whose
+  // process is gone is stale, never one that is merely old.
+  m_lock.setStaleLockTime(0);
+}
+
+bool SingleInstance::listen() {
+  // The lock decides who is primary; QLockFile takes over locks left behind
+  // by a crashed process. The socket alone can't tell a live primary from a
+  // stale socket file.
+  if (!m_lock.tryLock(0)) {
+    return false;
+  }
+
+  // Anything left at the socket path belongs to a process that is gone
+  QLocalServer::removeServer(m_serverName);
+
+  m_server = new QLocalServer(this);
+  m_server->setSocketOptions(QLocalServer::UserAccessOption);
+  if (!m_server->listen(m_serverName)) {
+    // We still own the profile, other launches just can't reach us
+    qWarning() << "Could not listen for other instances on" << m_serverName
+               << ":" << m_server->errorString();
+    return true;
+  }
+
+  connect(m_server, &QLocalServer::newConnection, this, [this]() {
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+      connect(socket, &QLocalSocket::disconnected, socket,
+              &QObject::deleteLater);
+      connect(socket, &QLocalSocket::readyRead, this,
+              [this, socket]() { readRequest(socket); });
+      readRequest(socket);
+    }
+  });
+  return true;
+}
+
+void SingleInstance::readRequest(QLocalSocket *socket) {
+  if (!socket->canReadLine()) {
+    return;
+  }
+
+  // One JSON object per line, answered with "ok"
+  const QJsonObject request =
+      QJsonDocument::fromJson(socket->readLine()).object();
+  socket->write("ok\n");
+  socket->flush();
+  socket->disconnectFromServer();
+
+  if (request.value("command").toString() == "activate") {
+    const QUrl url(request.value("url").toString());
+    const bool raise = request.value("raise").toBool(true);
+    qDebug() << "Activation request from another instance:" << url << raise;
+    emit activationRequested(url, raise);
+  }
+  emit requestReceived(request);
+}
+
+bool SingleInstance::forward(const QUrl &url, bool raise, int timeoutMs) {
+  QJsonObject request{{"command", "activate"}, {"raise", raise}};
+  if (url.isValid()) {
+    request["url"] = url.toString();
+  }
+  return send(request, timeoutMs);
+}
+
+bool SingleInstance::send(const QJsonObject &request, int timeoutMs) {
+  QLocalSocket socket;
+  socket.connectToServer(m_serverName);
+  if (!socket.waitForConnected(timeoutMs)) {
+    return false;
+  }
+
+  socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n');
+  if (!socket.waitForBytesWritten(timeoutMs)) {
+    return false;
+  }
+
+  // The primary may still be starting up and not yet running its event loop
+  while (!socket.canReadLine()) {
+    if (!socket.waitForReadyRead(timeoutMs)) {
+      return false;
+    }
+  }
+  return socket.readLine().trimmed() == "ok";
+}
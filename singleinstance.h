@@ -0,0 +1,53 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QJsonObject>
+#include <QLockFile>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+class QLocalServer;
+class QLocalSocket;
+
+// Makes sure only one process runs against a profile. The first launch owns a
+// lock file and a local socket named after the profile path; later launches
+// hand their request to it over the socket and exit before starting a second
+// Chromium instance on the same storage.
+class SingleInstance : public QObject {
+  Q_OBJECT
+
+public:
+  explicit SingleInstance(const QString &key, QObject *parent = nullptr);
+
+  // Becomes the primary instance for the key. Returns false if another
+  // process already is.
+  bool listen();
+
+  // Asks the primary instance to open url (if valid) and, if raise is set, to
+  // bring its window to the front. Blocks until it answers or timeoutMs
+  // passes.
+  bool forward(const QUrl &url, bool raise, int timeoutMs = 5000);
+
+  // Sends any request to the primary instance. Requests are JSON objects with
+  // a "command" key; forward() sends "activate".
+  bool send(const QJsonObject &request, int timeoutMs = 5000);
+
+  QString serverName() const { return m_serverName; }
+
+signals:
+  void activationRequested(const QUrl &url, bool raise);
+  void requestReceived(const QJsonObject &request);
+
+private:
+  void readRequest(QLocalSocket *socket);
+
+  QString m_serverName;
+  QLockFile m_lock;
+  QLocalServer *m_server = nullptr;
+};
+
+#endif // SINGLEINSTANCE_H
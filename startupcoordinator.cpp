@@ -0,0 +1,167 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "startupcoordinator.h"
+
+#include "startuptrace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QWebEngineView>
+
+#include <algorithm>
+#include <cmath>
+
+// A Chromium startup keeps about two cores busy
+static constexpr int coresPerStartup = 2;
+
+StartupCoordinator::StartupCoordinator(Priority priority, QObject *parent)
+    : QObject(parent), m_priority(priority), m_directory(directory()) {
+  m_retryTimer.setInterval(priority == Foreground ? 50 : 200);
+  connect(&m_retryTimer, &QTimer::timeout, this, &StartupCoordinator::retry);
+}
+
+StartupCoordinator::~StartupCoordinator() { release(); }
+
+QString StartupCoordinator::directory() {
+  // Shared by every instance whatever its app name, and cleared at logout
+  QString runtime =
+      QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+  if (runtime.isEmpty()) {
+    runtime = QDir::tempPath();
+  }
+  return runtime + "/webappcontainer-startup";
+}
+
+int StartupCoordinator::concurrencyLimit() {
+  const int cores = std::max(1, QThread::idealThreadCount());
+  const int maximum = std::max(1, cores / coresPerStartup);
+
+  // The 1 minute load average counts runnable processes, so cores minus load
+  // is roughly the number of idle cores
+  QFile loadavg("/proc/loadavg");
+  if (!loadavg.open(QIODevice::ReadOnly)) {
+    return maximum;
+  }
+  bool ok = false;
+  const double load = loadavg.readLine().split(' ').value(0).toDouble(&ok);
+  if (!ok) {
+    return maximum;
+  }
+
+  const int idle = int(std::floor(cores - load));
+  return std::clamp(idle / coresPerStartup, 1, maximum);
+}
+
+bool StartupCoordinator::foregroundWaiting() const {
+  const QStringList waiting =
+      QDir(m_directory).entryList({"waiting-*.lock"}, QDir::Files);
+  for (const QString &name : waiting) {
+    // A marker we can lock belonged to an instance that died while waiting,
+    // QLockFile removes it again on unlock
+    QLockFile marker(m_directory + "/" + name);
+    marker.setStaleLockTime(0);
+    if (!marker.tryLock(0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StartupCoordinator::tryAcquire(int limit) {
+  // Slot 0 is kept for foreground launches, unless it is the only one
+  int first = 0;
+  if (m_priority == Background) {
+    if (foregroundWaiting()) {
+      return false;
+    }
+    first = limit > 1 ? 1 : 0;
+  }
+
+  for (int i = first; i < limit; ++i) {
+    auto slot = std::make_unique<QLockFile>(m_directory +
+                                            QString("/slot-%1.lock").arg(i));
+    // Slots are held through the first page load, which can take longer than
+    // QLockFile's default stale time
+    slot->setStaleLockTime(0);
+    if (slot->tryLock(0)) {
+      m_slot = std::move(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void StartupCoordinator::acquire(int timeoutMs) {
+  if (m_slot) {
+    emit ready(true);
+    return;
+  }
+  if (m_retryTimer.isActive()) {
+    return;
+  }
+
+  QDir().mkpath(m_directory);
+  StartupTrace::begin("waitForStartupSlot");
+  m_waitTimer.start();
+  m_timeoutMs = timeoutMs;
+
+  const int limit = concurrencyLimit();
+  if (tryAcquire(limit)) {
+    finishWaiting(true);
+    return;
+  }
+
+  // Tell background launches that we are waiting
+  if (m_priority == Foreground) {
+    m_waiting = std::make_unique<QLockFile>(
+        m_directory +
+        QString("/waiting-%1.lock").arg(QCoreApplication::applicationPid()));
+    m_waiting->setStaleLockTime(0);
+    m_waiting->tryLock(0);
+  }
+
+  qDebug() << "Waiting for one of" << limit << "startup slots";
+  m_retryTimer.start();
+}
+
+void StartupCoordinator::retry() {
+  if (tryAcquire(concurrencyLimit())) {
+    qDebug() << "Got a startup slot after" << m_waitTimer.elapsed() << "ms";
+    finishWaiting(true);
+  } else if (m_waitTimer.elapsed() >= m_timeoutMs) {
+    qWarning() << "No startup slot after" << m_timeoutMs
+               << "ms, starting anyway";
+    finishWaiting(false);
+  }
+}
+
+void StartupCoordinator::finishWaiting(bool hasSlot) {
+  m_retryTimer.stop();
+  m_waiting.reset();
+  StartupTrace::end("waitForStartupSlot");
+  emit ready(hasSlot);
+}
+
+void StartupCoordinator::release() {
+  if (m_slot) {
+    m_slot->unlock();
+    m_slot.reset();
+  }
+}
+
+void StartupCoordinator::releaseAfterFirstLoad(QWebEngineView *view,
+                                               int timeoutMs) {
+  if (!m_slot) {
+    return;
+  }
+  connect(view, &QWebEngineView::loadFinished, this,
+          &StartupCoordinator::release, Qt::SingleShotConnection);
+  QTimer::singleShot(timeoutMs, this, &StartupCoordinator::release);
+}
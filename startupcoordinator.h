@@ -0,0 +1,65 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef STARTUPCOORDINATOR_H
+#define STARTUPCOORDINATOR_H
+
+#include <QElapsedTimer>
+#include <QLockFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <memory>
+
+class QWebEngineView;
+
+// Staggers the expensive part of startup, profile init and the first
+// navigation, when many instances start at once, e.g. at login. Instances
+// take one of a limited number of slot lock files in a directory shared by
+// all of them. The limit follows the CPU load, and minimized launches wait
+// while a foreground launch is waiting.
+class StartupCoordinator : public QObject {
+  Q_OBJECT
+
+public:
+  enum Priority { Foreground, Background };
+
+  explicit StartupCoordinator(Priority priority, QObject *parent = nullptr);
+  ~StartupCoordinator();
+
+  // Waits for a free slot, then emits ready(). The event loop keeps running
+  // meanwhile, so launches forwarded to this instance are still answered.
+  // Gives up after timeoutMs, so a wedged instance can delay the others but
+  // never stop them.
+  void acquire(int timeoutMs = 30000);
+  void release();
+
+  // Holds the slot until the view's first load finishes or timeoutMs passes
+  void releaseAfterFirstLoad(QWebEngineView *view, int timeoutMs = 20000);
+
+  // How many instances may start at the same time right now
+  static int concurrencyLimit();
+
+  static QString directory();
+
+signals:
+  // Startup can go ahead. hasSlot is false if acquire() gave up waiting.
+  void ready(bool hasSlot);
+
+private:
+  bool tryAcquire(int limit);
+  bool foregroundWaiting() const;
+  void retry();
+  void finishWaiting(bool hasSlot);
+
+  Priority m_priority;
+  QString m_directory;
+  std::unique_ptr<QLockFile> m_slot;
+  std::unique_ptr<QLockFile> m_waiting;
+  QTimer m_retryTimer;
+  QElapsedTimer m_waitTimer;
+  int m_timeoutMs = 0;
+};
+
+#endif // STARTUPCOORDINATOR_H
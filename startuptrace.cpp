@@ -0,0 +1,151 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "startuptrace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThread>
+#include <QWidget>
+
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  char phase;
+  qint64 timestamp; // microseconds since StartupTrace::init()
+  quintptr thread;
+  QJsonObject args;
+};
+
+QElapsedTimer s_clock;
+QString s_path;
+std::vector<TraceEvent> s_events;
+
+} // namespace
+
+bool StartupTrace::s_enabled = false;
+
+void StartupTrace::init(int argc, char *argv[]) {
+  // QCommandLineParser needs a QCoreApplication, so look for the option by
+  // hand. The parser in main() accepts and ignores it later.
+  for (int i = 1; i < argc; ++i) {
+    const QByteArray arg(argv[i]);
+    if (arg.startsWith("--startup-trace=")) {
+      s_path = QString::fromLocal8Bit(arg.mid(qstrlen("--startup-trace=")));
+    } else if (arg == "--startup-trace" && i + 1 < argc) {
+      s_path = QString::fromLocal8Bit(argv[i + 1]);
+    }
+  }
+
+  if (s_path.isEmpty()) {
+    return;
+  }
+
+  s_clock.start();
+  s_events.reserve(64);
+  s_enabled = true;
+  // The monotonic clock is shared between processes, so whoever started us
+  // can add the time spent before main() to the trace
+  mark("processStart", {{"monotonicMs", s_clock.msecsSinceReference()}});
+}
+
+void StartupTrace::record(const char *name, char phase,
+                          const QJsonObject &args) {
+  s_events.push_back(TraceEvent{name, phase, s_clock.nsecsElapsed() / 1000,
+                                quintptr(QThread::currentThreadId()), args});
+}
+
+// QWebEngineView renders through a QQuickWidget focus proxy that only exists
+// once the first renderer has been created. Its frameSwapped() signal fires
+// when a frame has actually been presented.
+class FirstFrameWatcher : public QObject {
+  Q_OBJECT
+
+public:
+  explicit FirstFrameWatcher(QWidget *view) : QObject(view), m_view(view) {
+    view->installEventFilter(this);
+    watchProxy();
+  }
+
+protected:
+  bool eventFilter(QObject *, QEvent *event) override {
+    if (event->type() == QEvent::ChildAdded ||
+        event->type() == QEvent::ChildPolished) {
+      watchProxy();
+    }
+    return false;
+  }
+
+private slots:
+  void presented() {
+    StartupTrace::mark("firstFramePresented");
+    StartupTrace::write();
+    deleteLater();
+  }
+
+private:
+  void watchProxy() {
+    QWidget *proxy = m_view->focusProxy();
+    if (!proxy || proxy->metaObject()->indexOfSignal("frameSwapped()") < 0) {
+      return;
+    }
+    m_view->removeEventFilter(this);
+    connect(proxy, SIGNAL(frameSwapped()), this, SLOT(presented()),
+            Qt::SingleShotConnection);
+  }
+
+  QWidget *m_view;
+};
+
+void StartupTrace::markFirstFrame(QWidget *view) {
+  if (s_enabled) {
+    new FirstFrameWatcher(view);
+  }
+}
+
+void StartupTrace::write() {
+  if (!s_enabled) {
+    return;
+  }
+
+  const qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray events;
+  for (const TraceEvent &event : s_events) {
+    QJsonObject json{
+        {"name", QString::fromLatin1(event.name)},
+        {"cat", "startup"},
+        {"ph", QString(QLatin1Char(event.phase))},
+        {"ts", event.timestamp},
+        {"pid", pid},
+        {"tid", qint64(event.thread)},
+    };
+    if (event.phase == 'i') {
+      // Process wide instant events show up as a line across all tracks
+      json["s"] = "p";
+    }
+    if (!event.args.isEmpty()) {
+      json["args"] = event.args;
+    }
+    events.append(json);
+  }
+
+  QSaveFile file(s_path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write startup trace:" << file.errorString();
+    return;
+  }
+  file.write(QJsonDocument(QJsonObject{{"traceEvents", events},
+                                       {"displayTimeUnit", "ms"}})
+                 .toJson(QJsonDocument::Compact));
+  file.commit();
+}
+
+#include "startuptrace.moc"
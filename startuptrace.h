@@ -0,0 +1,64 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QJsonObject>
+#include <QString>
+
+class QWidget;
+
+// Records startup phases with monotonic timestamps and writes them as Chrome
+// trace-event JSON, which opens in Perfetto and chrome://tracing. Enabled by
+// --startup-trace=<file>; when it's off every call is a single branch.
+// Events are only recorded from the GUI thread.
+class StartupTrace {
+public:
+  // Reads --startup-trace from argv. Must run first thing in main(), before
+  // QApplication exists, so the earliest phases can be timed.
+  static void init(int argc, char *argv[]);
+  static bool isEnabled() { return s_enabled; }
+
+  static void begin(const char *name) {
+    if (s_enabled) {
+      record(name, 'B');
+    }
+  }
+  static void end(const char *name) {
+    if (s_enabled) {
+      record(name, 'E');
+    }
+  }
+  static void mark(const char *name, const QJsonObject &args = {}) {
+    if (s_enabled) {
+      record(name, 'i', args);
+    }
+  }
+
+  // Marks the first frame the view's render widget presents
+  static void markFirstFrame(QWidget *view);
+
+  // Writes all events recorded so far. Safe to call more than once.
+  static void write();
+
+  // Times the enclosing block
+  class Scope {
+  public:
+    explicit Scope(const char *name) : m_name(name) { begin(m_name); }
+    ~Scope() { end(m_name); }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    const char *m_name;
+  };
+
+private:
+  static void record(const char *name, char phase,
+                     const QJsonObject &args = {});
+
+  static bool s_enabled;
+};
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,232 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../publicsuffixlist.h"
+
+// Count heap allocations made by the current thread while counting is enabled
+static thread_local bool s_countAllocations = false;
+static std::atomic<qint64> s_allocatedBytes{0};
+
+void *operator new(std::size_t size) {
+  if (s_countAllocations) {
+    s_allocatedBytes += qint64(size);
+  }
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+class BenchPublicSuffixList : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+
+  // First instance() call, as paid by the application at startup
+  void benchInstance();
+
+  // Parsing the text list, the fallback when no compiled table is built in
+  void benchParseTextList();
+
+  // Validating a mapped snapshot, as done on every launch and hot reload
+  void benchReadSnapshot();
+
+  // Per category lookup latency over the host corpus
+  void benchBaseDomainOffset_data();
+  void benchBaseDomainOffset();
+  void benchGetBaseDomain_data();
+  void benchGetBaseDomain();
+  void benchIsSameDomain_data();
+  void benchIsSameDomain();
+
+  // Heap bytes allocated per lookup over the whole corpus
+  void benchAllocations_data();
+  void benchAllocations();
+
+private:
+  void addCorpusRows();
+  static psl::TableBuilder parseTextList(const QByteArray &list);
+
+  QList<QPair<QString, QStringList>> m_corpus;
+  QStringList m_allHosts;
+  QByteArray m_textList;
+};
+
+void BenchPublicSuffixList::initTestCase() {
+  // Keep a snapshot from update-psl in the user's cache out of the numbers
+  QStandardPaths::setTestModeEnabled(true);
+
+  QFile hosts(QStringLiteral(PSL_HOSTS_FILE));
+  QVERIFY2(hosts.open(QIODevice::ReadOnly | QIODevice::Text),
+           qPrintable(hosts.errorString()));
+
+  QTextStream in(&hosts);
+  while (!in.atEnd()) {
+    const QString line = in.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith('#')) {
+      continue;
+    }
+    if (line.startsWith('[') && line.endsWith(']')) {
+      m_corpus.append({line.sliced(1, line.size() - 2), QStringList()});
+      continue;
+    }
+    if (!m_corpus.isEmpty()) {
+      m_corpus.last().second.append(line);
+      m_allHosts.append(line);
+    }
+  }
+  QVERIFY(!m_allHosts.isEmpty());
+
+  QFile list(QStringLiteral(PSL_FILE));
+  if (list.open(QIODevice::ReadOnly)) {
+    m_textList = list.readAll();
+  }
+}
+
+void BenchPublicSuffixList::addCorpusRows() {
+  QTest::addColumn<QStringList>("hosts");
+  for (const auto &[category, hosts] : std::as_const(m_corpus)) {
+    QTest::newRow(qPrintable(category)) << hosts;
+  }
+  QTest::newRow("all") << m_allHosts;
+}
+
+psl::TableBuilder BenchPublicSuffixList::parseTextList(const QByteArray &list) {
+  psl::TableBuilder builder;
+  QTextStream in(list);
+  while (!in.atEnd()) {
+    const QString line = in.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith("//")) {
+      continue;
+    }
+    const QString rule = line.toLower();
+    const QStringView view(rule);
+    builder.addRule(std::u16string_view(view.utf16(), view.size()));
+  }
+  builder.build();
+  return builder;
+}
+
+void BenchPublicSuffixList::benchInstance() {
+  QBENCHMARK_ONCE { QVERIFY(PublicSuffixList::instance() != nullptr); }
+}
+
+void BenchPublicSuffixList::benchParseTextList() {
+  if (m_textList.isEmpty()) {
+    QSKIP("public_suffix_list.dat not found");
+  }
+
+  QBENCHMARK {
+    psl::TableBuilder builder = parseTextList(m_textList);
+    QVERIFY(builder.table().isValid());
+  }
+}
+
+void BenchPublicSuffixList::benchReadSnapshot() {
+  if (m_textList.isEmpty()) {
+    QSKIP("public_suffix_list.dat not found");
+  }
+
+  const psl::TableBuilder builder = parseTextList(m_textList);
+  const std::string snapshot = psl::writeSnapshot(builder.table(), "bench");
+
+  QBENCHMARK {
+    QVERIFY(psl::readSnapshot(snapshot.data(), snapshot.size()).isValid());
+  }
+}
+
+void BenchPublicSuffixList::benchBaseDomainOffset_data() { addCorpusRows(); }
+
+void BenchPublicSuffixList::benchBaseDomainOffset() {
+  QFETCH(QStringList, hosts);
+  const PublicSuffixList *psl = PublicSuffixList::instance();
+
+  qsizetype total = 0;
+  QBENCHMARK {
+    for (const QString &host : std::as_const(hosts)) {
+      total += psl->baseDomainOffset(host);
+    }
+  }
+  QVERIFY(total >= 0);
+}
+
+void BenchPublicSuffixList::benchGetBaseDomain_data() { addCorpusRows(); }
+
+void BenchPublicSuffixList::benchGetBaseDomain() {
+  QFETCH(QStringList, hosts);
+  const PublicSuffixList *psl = PublicSuffixList::instance();
+
+  qsizetype total = 0;
+  QBENCHMARK {
+    for (const QString &host : std::as_const(hosts)) {
+      total += psl->getBaseDomain(host).size();
+    }
+  }
+  QVERIFY(total > 0);
+}
+
+void BenchPublicSuffixList::benchIsSameDomain_data() { addCorpusRows(); }
+
+void BenchPublicSuffixList::benchIsSameDomain() {
+  QFETCH(QStringList, hosts);
+  const PublicSuffixList *psl = PublicSuffixList::instance();
+
+  // Compare every host with its neighbour, like a popup opened from a page
+  int same = 0;
+  QBENCHMARK {
+    for (qsizetype i = 0; i < hosts.size(); ++i) {
+      same += psl->isSameDomain(hosts.at(i), hosts.at((i + 1) % hosts.size()));
+    }
+  }
+  QVERIFY(same >= 0);
+}
+
+void BenchPublicSuffixList::benchAllocations_data() {
+  QTest::addColumn<int>("lookup");
+  QTest::newRow("baseDomainOffset") << 0;
+  QTest::newRow("getBaseDomain") << 1;
+  QTest::newRow("isSameDomain") << 2;
+}
+
+void BenchPublicSuffixList::benchAllocations() {
+  QFETCH(int, lookup);
+  const PublicSuffixList *psl = PublicSuffixList::instance();
+
+  qsizetype total = 0;
+  s_allocatedBytes = 0;
+  s_countAllocations = true;
+  for (const QString &host : std::as_const(m_allHosts)) {
+    switch (lookup) {
+    case 0:
+      total += psl->baseDomainOffset(host);
+      break;
+    case 1:
+      total += psl->getBaseDomain(host).size();
+      break;
+    case 2:
+      total += psl->isSameDomain(host, u"www.example.com");
+      break;
+    }
+  }
+  s_countAllocations = false;
+  QVERIFY(total >= 0);
+
+  QTest::setBenchmarkResult(qreal(s_allocatedBytes.load()) / m_allHosts.size(),
+                            QTest::BytesAllocated);
+}
+
+QTEST_GUILESS_MAIN(BenchPublicSuffixList)
+#include "bench_publicsuffixlist.moc"
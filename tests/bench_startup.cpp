@@ -0,0 +1,299 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QTest>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "webapprunner.h"
+
+// Launches the real application against a local copy of tests/resources/spa
+// and reports time to window, time to loadFinished and peak resident memory
+// as percentiles. Results are written to BENCH_STARTUP_RESULTS and compared
+// with BENCH_STARTUP_BASELINE when that file exists.
+//
+// BENCH_STARTUP_RUNS in the environment sets the runs per row (default 10),
+// BENCH_STARTUP_TOLERANCE the allowed regression (default 0.2, i.e. 20%).
+class BenchStartup : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+
+  // A fresh profile on every run, like the first launch of a new app, and
+  // the same profile over and over, like every launch after that. The cold
+  // rows drop the profile from the page cache before each run, as after a
+  // reboot, with and without reading it ahead.
+  void benchStartup_data();
+  void benchStartup();
+
+  // Launches handed to a launcher that was started once and is warm. Each
+  // one opens a new profile, so the row compares with "new profile" above.
+  void benchLauncher();
+
+private:
+  struct Run {
+    double windowMs;
+    double loadFinishedMs;
+    double peakResidentMiB; // negative if not measured
+  };
+
+  static double percentile(QList<double> values, double p);
+  static QJsonObject summarize(const QList<double> &values);
+  void report(const QString &row, const QList<Run> &runs);
+  void compareWithBaseline(const QString &row, const QJsonObject &metrics);
+
+  FixtureServer m_server;
+  int m_runs = 10;
+  double m_tolerance = 0.2;
+  QJsonObject m_baseline;
+  QJsonObject m_results;
+};
+
+void BenchStartup::initTestCase() {
+  if (!m_server.start(QStringLiteral(SPA_FIXTURE_DIR))) {
+    QSKIP("python3 is required to serve the fixture");
+  }
+
+  bool ok = false;
+  const int runs = qEnvironmentVariableIntValue("BENCH_STARTUP_RUNS", &ok);
+  if (ok && runs > 0) {
+    m_runs = runs;
+  }
+  const double tolerance =
+      qEnvironmentVariable("BENCH_STARTUP_TOLERANCE").toDouble(&ok);
+  if (ok && tolerance >= 0) {
+    m_tolerance = tolerance;
+  }
+
+  QFile baseline(QStringLiteral(BENCH_STARTUP_BASELINE));
+  if (baseline.open(QIODevice::ReadOnly)) {
+    m_baseline = QJsonDocument::fromJson(baseline.readAll()).object();
+  }
+  if (m_baseline.isEmpty()) {
+    qInfo() << "No baseline at" << BENCH_STARTUP_BASELINE
+            << "- reporting only";
+  } else if (m_baseline.value("cpus").toInt() !=
+             QThread::idealThreadCount()) {
+    qWarning() << "The baseline was taken on a machine with"
+               << m_baseline.value("cpus").toInt() << "CPUs, this one has"
+               << QThread::idealThreadCount();
+  }
+}
+
+void BenchStartup::cleanupTestCase() {
+  if (m_results.isEmpty()) {
+    return;
+  }
+
+  // Copy this file over the baseline to accept the numbers
+  QJsonObject document;
+  document["machine"] = QSysInfo::prettyProductName();
+  document["kernel"] = QSysInfo::kernelVersion();
+  document["cpus"] = QThread::idealThreadCount();
+  document["runs"] = m_runs;
+  document["rows"] = m_results;
+
+  QSaveFile file(QStringLiteral(BENCH_STARTUP_RESULTS));
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QJsonDocument(document).toJson());
+    file.commit();
+  }
+  qInfo() << "Results written to" << BENCH_STARTUP_RESULTS;
+}
+
+void BenchStartup::benchStartup_data() {
+  QTest::addColumn<bool>("freshProfile");
+  QTest::addColumn<bool>("coldCache");
+  QTest::addColumn<QStringList>("arguments");
+
+  QTest::newRow("new profile") << true << false << QStringList();
+  QTest::newRow("existing profile") << false << false << QStringList();
+  QTest::newRow("cold cache") << false << true << QStringList();
+  QTest::newRow("cold cache, no readahead")
+      << false << true << QStringList{"--no-readahead"};
+}
+
+void BenchStartup::benchStartup() {
+  QFETCH(bool, freshProfile);
+  QFETCH(bool, coldCache);
+  QFETCH(QStringList, arguments);
+
+  const QString url = m_server.url("index.html");
+  std::unique_ptr<WebAppRunner> runner;
+  QList<Run> runs;
+
+  // The existing profile row starts with an unmeasured run that creates it
+  const int total = freshProfile ? m_runs : m_runs + 1;
+  for (int i = 0; i < total; ++i) {
+    if (!runner || freshProfile) {
+      runner = std::make_unique<WebAppRunner>(WEBAPPCONTAINER_PATH);
+    }
+    if (coldCache) {
+      runner->evictFromPageCache();
+    }
+    QVERIFY(runner->start(QStringList{"--profile", "bench", "--url", url} +
+                          arguments));
+
+    if (!runner->waitForEvent("firstLoadFinished", 60000)) {
+      if (runs.isEmpty()) {
+        QSKIP("webappcontainer could not load a page in this environment");
+      }
+      QFAIL(qPrintable(QString("Run %1 did not finish loading").arg(i)));
+    }
+    // Timing an error page or the default start page would be meaningless
+    const QJsonObject load = runner->eventArgs("firstLoadFinished");
+    QVERIFY2(runner->loaded(url),
+             qPrintable(QString("Run %1 loaded %2 (%3) instead of %4")
+                            .arg(i)
+                            .arg(load["url"].toString(),
+                                 load["ok"].toBool() ? QStringLiteral("ok")
+                                                     : QStringLiteral("failed"),
+                                 url)));
+
+    const qint64 offset = runner->launchOffset();
+    const qint64 window = runner->eventTime("windowShown");
+    const qint64 loaded = runner->eventTime("firstLoadFinished");
+    const qint64 peak = runner->peakResidentKb();
+    runner->stop();
+
+    QVERIFY(offset >= 0 && window >= 0);
+    if (!freshProfile && i == 0) {
+      continue;
+    }
+    runs.append({(offset + window) / 1000.0, (offset + loaded) / 1000.0,
+                 peak / 1024.0});
+  }
+
+  report(QTest::currentDataTag(), runs);
+}
+
+void BenchStartup::benchLauncher() {
+  const QString url = m_server.url("index.html");
+  WebAppRunner launcher(WEBAPPCONTAINER_PATH);
+  QVERIFY(launcher.start({"--launcher"}));
+  if (!launcher.waitForEvent("launcherReady", 60000)) {
+    QSKIP("The launcher could not start in this environment");
+  }
+
+  // The launcher's memory grows with every app it keeps open, so only the
+  // times are comparable with a standalone launch
+  QList<Run> runs;
+  for (int i = 0; i < m_runs; ++i) {
+    const QString profile = QString("bench-%1").arg(i);
+    const qint64 launched =
+        launcher.launch({"--profile", profile, "--url", url});
+    QVERIFY2(launched >= 0,
+             qPrintable(QString("Launch %1 was not handed to the launcher")
+                            .arg(i)));
+    QVERIFY2(launcher.waitForEvent("firstLoadFinished", 60000, profile),
+             qPrintable(QString("Launch %1 did not finish loading").arg(i)));
+    QVERIFY2(launcher.loaded(url, profile),
+             qPrintable(QString("Launch %1 did not load %2").arg(i).arg(url)));
+
+    const qint64 window = launcher.eventMonotonicMs("windowShown", profile);
+    const qint64 loaded =
+        launcher.eventMonotonicMs("firstLoadFinished", profile);
+    QVERIFY(window >= 0);
+    runs.append({double(window - launched), double(loaded - launched), -1});
+  }
+  launcher.stop();
+
+  const QString row = "launcher, new profile";
+  report(row, runs);
+
+  const QJsonObject cold = m_results.value("new profile").toObject();
+  if (!cold.isEmpty()) {
+    const QJsonObject warm = m_results.value(row).toObject();
+    qInfo().noquote() << QString("  loadFinishedMs p50 %1 warm, %2 cold")
+                             .arg(warm["loadFinishedMs"]["p50"].toDouble(), 0,
+                                  'f', 1)
+                             .arg(cold["loadFinishedMs"]["p50"].toDouble(), 0,
+                                  'f', 1);
+  }
+}
+
+void BenchStartup::report(const QString &row, const QList<Run> &runs) {
+  QList<double> window, loaded, peak;
+  for (const Run &run : runs) {
+    window.append(run.windowMs);
+    loaded.append(run.loadFinishedMs);
+    if (run.peakResidentMiB >= 0) {
+      peak.append(run.peakResidentMiB);
+    }
+  }
+
+  QJsonObject metrics;
+  metrics["windowMs"] = summarize(window);
+  metrics["loadFinishedMs"] = summarize(loaded);
+  if (!peak.isEmpty()) {
+    metrics["peakResidentMiB"] = summarize(peak);
+  }
+
+  qInfo().noquote() << QString("%1 over %2 runs:").arg(row).arg(runs.size());
+  for (auto it = metrics.constBegin(); it != metrics.constEnd(); ++it) {
+    const QJsonObject summary = it.value().toObject();
+    qInfo().noquote() << QString("  %1 p50 %2  p90 %3  max %4")
+                             .arg(it.key(), -16)
+                             .arg(summary["p50"].toDouble(), 8, 'f', 1)
+                             .arg(summary["p90"].toDouble(), 8, 'f', 1)
+                             .arg(summary["max"].toDouble(), 8, 'f', 1);
+  }
+
+  m_results[row] = metrics;
+  compareWithBaseline(row, metrics);
+}
+
+// Nearest rank, so every reported value was actually measured
+double BenchStartup::percentile(QList<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  const qsizetype rank = qsizetype(std::ceil(p * values.size()));
+  return values.at(std::clamp<qsizetype>(rank - 1, 0, values.size() - 1));
+}
+
+QJsonObject BenchStartup::summarize(const QList<double> &values) {
+  return {
+      {"p50", percentile(values, 0.5)},
+      {"p90", percentile(values, 0.9)},
+      {"max", percentile(values, 1.0)},
+  };
+}
+
+void BenchStartup::compareWithBaseline(const QString &row,
+                                       const QJsonObject &metrics) {
+  const QJsonObject baseline =
+      m_baseline.value("rows").toObject().value(row).toObject();
+  if (baseline.isEmpty()) {
+    return;
+  }
+
+  // The maximum is too noisy to gate on, the median and p90 are not
+  QStringList regressions;
+  for (auto it = metrics.constBegin(); it != metrics.constEnd(); ++it) {
+    for (const char *p : {"p50", "p90"}) {
+      const double before =
+          baseline.value(it.key()).toObject().value(p).toDouble();
+      const double now = it.value().toObject().value(p).toDouble();
+      if (before > 0 && now > before * (1 + m_tolerance)) {
+        regressions.append(QString("%1 %2 %3 -> %4")
+                               .arg(it.key(), p)
+                               .arg(before, 0, 'f', 1)
+                               .arg(now, 0, 'f', 1));
+      }
+    }
+  }
+  QVERIFY2(regressions.isEmpty(), qPrintable(regressions.join(", ")));
+}
+
+QTEST_GUILESS_MAIN(BenchStartup)
+#include "bench_startup.moc"
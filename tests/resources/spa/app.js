@@ -0,0 +1,77 @@
+// Stand-in for a single page app: a client side router, a data fetch and a
+// few hundred rendered rows, so startup pays for script parsing, layout and
+// a round trip after the document has loaded.
+'use strict';
+
+const folders = ['Inbox', 'Starred', 'Sent', 'Drafts', 'Archive', 'Spam'];
+const state = { folder: 'Inbox', query: '', messages: [] };
+
+function escape(text) {
+  return text.replace(/[&<>"]/g, (c) => ({
+    '&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;',
+  })[c]);
+}
+
+function renderFolders() {
+  document.getElementById('folders').innerHTML = folders
+    .map((name) => `<a href="#/${name}"
+                       class="${name === state.folder ? 'active' : ''}">
+                      ${name}</a>`)
+    .join('');
+}
+
+function renderMessages() {
+  const query = state.query.toLowerCase();
+  const rows = state.messages
+    .filter((m) => m.folder === state.folder)
+    .filter((m) => !query || m.subject.toLowerCase().includes(query))
+    .map((m) => `<div class="message${m.unread ? ' unread' : ''}">
+                   <span>${escape(m.from)}</span>
+                   <span class="snippet">${escape(m.subject)} -
+                     ${escape(m.snippet)}</span>
+                   <time>${m.time}</time>
+                 </div>`);
+  const main = document.getElementById('messages');
+  main.innerHTML = rows.join('');
+  main.removeAttribute('aria-busy');
+}
+
+function route() {
+  const folder = decodeURIComponent(location.hash.slice(2));
+  state.folder = folders.includes(folder) ? folder : 'Inbox';
+  renderFolders();
+  renderMessages();
+}
+
+// Expands the fixture into a mailbox of a realistic size
+function expand(data) {
+  const messages = [];
+  for (let i = 0; i < 600; ++i) {
+    const sender = data.senders[i % data.senders.length];
+    const subject = data.subjects[(i * 7) % data.subjects.length];
+    messages.push({
+      folder: folders[i % 5 === 0 ? (i / 5) % folders.length : 0],
+      from: sender,
+      subject: `${subject} #${i}`,
+      snippet: data.snippet,
+      unread: i % 3 === 0,
+      time: `${(9 + (i % 12)).toString().padStart(2, '0')}:${(i % 60)
+        .toString().padStart(2, '0')}`,
+    });
+  }
+  return messages;
+}
+
+window.addEventListener('hashchange', route);
+document.getElementById('search').addEventListener('input', (event) => {
+  state.query = event.target.value;
+  renderMessages();
+});
+
+renderFolders();
+fetch('data.json')
+  .then((response) => response.json())
+  .then((data) => {
+    state.messages = expand(data);
+    route();
+  });
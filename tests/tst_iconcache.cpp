@@ -0,0 +1,170 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+
+#include "../iconcache.h"
+
+class TestIconCache : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void init();
+
+  // Test that SVGs are rendered at every icon size instead of scaled
+  void testSvgSizes();
+
+  // Test that a second launch reads the rasters instead of the source, and
+  // that a changed source is decoded again
+  void testDiskCache();
+
+  // Test that the notification dot is drawn on every size
+  void testNotificationDot();
+
+  // Test that missing and unreadable files give a null icon
+  void testInvalid();
+
+private:
+  QString writeSvg(const QString &name);
+  QString writePng(const QString &name, const QColor &color);
+
+  QTemporaryDir m_dir;
+};
+
+void TestIconCache::initTestCase() {
+  // Keep the user's icon cache out of the test
+  QStandardPaths::setTestModeEnabled(true);
+  QDir(IconCache::cacheDirectory()).removeRecursively();
+  QVERIFY(m_dir.isValid());
+}
+
+void TestIconCache::init() {
+  // Every test function is a new launch as far as the cache is concerned
+  QThreadPool::globalInstance()->waitForDone();
+  IconCache::clearMemoryCache();
+}
+
+QString TestIconCache::writeSvg(const QString &name) {
+  const QString path = m_dir.filePath(name);
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return QString();
+  }
+  file.write(R"(<svg xmlns="http://www.w3.org/2000/svg" viewBox="0 0 10 10">
+      <rect width="10" height="10" fill="#1a73e8"/></svg>)");
+  return path;
+}
+
+QString TestIconCache::writePng(const QString &name, const QColor &color) {
+  QImage image(100, 100, QImage::Format_ARGB32);
+  image.fill(color);
+  const QString path = m_dir.filePath(name);
+  return image.save(path, "PNG") ? path : QString();
+}
+
+void TestIconCache::testSvgSizes() {
+  const QString path = writeSvg("app.svg");
+  QVERIFY(!path.isEmpty());
+
+  const QIcon icon = IconCache::icon(path);
+  QVERIFY(!icon.isNull());
+
+  const qreal ratio = qApp->devicePixelRatio();
+  const QList<int> sizes = IconCache::iconSizes();
+  for (int size : sizes) {
+    const QPixmap pixmap = icon.pixmap(QSize(size, size), ratio);
+    QCOMPARE(pixmap.deviceIndependentSize().toSize(), QSize(size, size));
+    // The edge pixels are fully covered, so nothing was interpolated
+    const QImage image = pixmap.toImage();
+    QCOMPARE(image.pixelColor(image.width() - 1, image.height() - 1),
+             QColor("#1a73e8"));
+  }
+
+  // The same icon comes back without decoding again
+  QCOMPARE(IconCache::icon(path).cacheKey(), icon.cacheKey());
+}
+
+void TestIconCache::testDiskCache() {
+  const QString path = writePng("tray.png", Qt::green);
+  QVERIFY(!path.isEmpty());
+  QVERIFY(!IconCache::icon(path).isNull());
+  QThreadPool::globalInstance()->waitForDone();
+  QVERIFY(!QDir(IconCache::cacheDirectory())
+               .entryList({"*.icon"}, QDir::Files)
+               .isEmpty());
+
+  // Replace the file with something that can't be decoded, but keep its
+  // size and time: only the cache can produce the icon now
+  QFile file(path);
+  const QDateTime modified = QFileInfo(path).lastModified();
+  const qint64 size = file.size();
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write(QByteArray(size, 'x'));
+  file.close();
+  QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+
+  IconCache::clearMemoryCache();
+  const QIcon cached = IconCache::icon(path);
+  QVERIFY(!cached.isNull());
+  QCOMPARE(cached.pixmap(QSize(32, 32)).toImage().pixelColor(16, 16),
+           QColor(Qt::green));
+
+  // A newer file is decoded again, and this one can't be
+  QVERIFY(file.setFileTime(modified.addSecs(10),
+                           QFileDevice::FileModificationTime));
+  IconCache::clearMemoryCache();
+  QTest::ignoreMessage(QtWarningMsg,
+                       QRegularExpression("Invalid or unsupported image"));
+  QVERIFY(IconCache::icon(path).isNull());
+}
+
+void TestIconCache::testNotificationDot() {
+  const QString path = writePng("dot.png", Qt::blue);
+  QVERIFY(!path.isEmpty());
+
+  const QIcon plain = IconCache::icon(path);
+  const QIcon dotted = IconCache::icon(path, IconCache::NotificationDot);
+  QVERIFY(plain.cacheKey() != dotted.cacheKey());
+
+  const QList<int> sizes = IconCache::iconSizes();
+  for (int size : sizes) {
+    const QImage image = dotted.pixmap(QSize(size, size), 1.0).toImage();
+    // The middle of the dot, a sixth of the width in from the top right
+    const int x = image.width() - image.width() / 6 - 1;
+    const int y = image.width() / 6 + 1;
+    QCOMPARE(image.pixelColor(x, y), QColor(255, 59, 48));
+    QCOMPARE(image.pixelColor(0, image.height() - 1), QColor(Qt::blue));
+  }
+
+  // Icons that don't come from a file get the same dot
+  const QIcon decorated =
+      IconCache::decorate(plain, IconCache::NotificationDot);
+  const QImage image = decorated.pixmap(QSize(48, 48), 1.0).toImage();
+  QCOMPARE(image.pixelColor(48 - 8 - 1, 8 + 1), QColor(255, 59, 48));
+}
+
+void TestIconCache::testInvalid() {
+  QVERIFY(IconCache::icon(QString()).isNull());
+  QVERIFY(IconCache::icon(m_dir.filePath("missing.png")).isNull());
+
+  const QString path = m_dir.filePath("text.png");
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("not an image");
+  file.close();
+
+  QTest::ignoreMessage(QtWarningMsg,
+                       QRegularExpression("Invalid or unsupported image"));
+  QVERIFY(IconCache::icon(path).isNull());
+}
+
+QTEST_MAIN(TestIconCache)
+#include "tst_iconcache.moc"
@@ -0,0 +1,195 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "../memoryprofile.h"
+#include "webapprunner.h"
+
+class TestMemoryProfile : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+  void cleanup();
+
+  // Test that preset names round trip and unknown names are rejected
+  void testNames();
+
+  // Test that --memory-profile is read in both argument forms
+  void testFromArguments_data();
+  void testFromArguments();
+
+  // Test that switches the user already passed win over the preset
+  void testUserFlagsWin();
+
+  // Test that the presets order resident memory as advertised, with a page
+  // that embeds iframes from another site
+  void testResidentMemory();
+
+private:
+  QByteArray m_savedFlags;
+};
+
+void TestMemoryProfile::init() {
+  m_savedFlags = qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+}
+
+void TestMemoryProfile::cleanup() {
+  qputenv("QTWEBENGINE_CHROMIUM_FLAGS", m_savedFlags);
+}
+
+void TestMemoryProfile::testNames() {
+  for (MemoryProfile::Preset preset :
+       {MemoryProfile::Low, MemoryProfile::Balanced,
+        MemoryProfile::Performance}) {
+    MemoryProfile::Preset parsed = MemoryProfile::Default;
+    QVERIFY(MemoryProfile::fromString(MemoryProfile::name(preset), parsed));
+    QCOMPARE(parsed, preset);
+    QVERIFY(!MemoryProfile::chromiumFlags(preset).isEmpty());
+    QVERIFY(MemoryProfile::httpCacheSize(preset) > 0);
+  }
+
+  MemoryProfile::Preset parsed = MemoryProfile::Balanced;
+  QVERIFY(!MemoryProfile::fromString("tiny", parsed));
+  QCOMPARE(parsed, MemoryProfile::Balanced);
+  QVERIFY(MemoryProfile::chromiumFlags(MemoryProfile::Default).isEmpty());
+
+  // Smaller presets never get a larger cache
+  QVERIFY(MemoryProfile::httpCacheSize(MemoryProfile::Low) <
+          MemoryProfile::httpCacheSize(MemoryProfile::Balanced));
+  QVERIFY(MemoryProfile::httpCacheSize(MemoryProfile::Balanced) <
+          MemoryProfile::httpCacheSize(MemoryProfile::Performance));
+}
+
+void TestMemoryProfile::testFromArguments_data() {
+  QTest::addColumn<QStringList>("arguments");
+  QTest::addColumn<int>("preset");
+
+  QTest::newRow("none") << QStringList{"--minimized"}
+                        << int(MemoryProfile::Default);
+  QTest::newRow("equals") << QStringList{"--memory-profile=low"}
+                          << int(MemoryProfile::Low);
+  QTest::newRow("separate") << QStringList{"--memory-profile", "balanced"}
+                            << int(MemoryProfile::Balanced);
+  QTest::newRow("unknown") << QStringList{"--memory-profile=tiny"}
+                           << int(MemoryProfile::Default);
+}
+
+void TestMemoryProfile::testFromArguments() {
+  QFETCH(QStringList, arguments);
+  QFETCH(int, preset);
+
+  QList<QByteArray> storage{"webappcontainer"};
+  for (const QString &argument : arguments) {
+    storage.append(argument.toLocal8Bit());
+  }
+  std::vector<char *> argv;
+  for (QByteArray &argument : storage) {
+    argv.push_back(argument.data());
+  }
+
+  if (arguments.contains("--memory-profile=tiny")) {
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression("Unknown --memory-profile"));
+  }
+  QCOMPARE(int(MemoryProfile::fromArguments(int(argv.size()), argv.data())),
+           preset);
+  QCOMPARE(int(MemoryProfile::active()), preset);
+}
+
+void TestMemoryProfile::testUserFlagsWin() {
+  qputenv("QTWEBENGINE_CHROMIUM_FLAGS",
+          "--renderer-process-limit=8 --js-flags=--expose-gc");
+
+  const QByteArrayList applied =
+      MemoryProfile::applyChromiumFlags(MemoryProfile::Low);
+  const QByteArray flags = qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+
+  QVERIFY(flags.startsWith("--renderer-process-limit=8 "
+                           "--js-flags=--expose-gc"));
+  QVERIFY(!flags.contains("--renderer-process-limit=2"));
+  QVERIFY(!flags.contains("--max-old-space-size"));
+  QVERIFY(flags.contains("--process-per-site"));
+  QVERIFY(applied.contains("--process-per-site"));
+  QVERIFY(!applied.contains("--renderer-process-limit=2"));
+
+  // Every switch is one word, QtWebEngine splits the variable on spaces
+  const QByteArrayList presetFlags =
+      MemoryProfile::chromiumFlags(MemoryProfile::Low) +
+      MemoryProfile::chromiumFlags(MemoryProfile::Balanced) +
+      MemoryProfile::chromiumFlags(MemoryProfile::Performance);
+  for (const QByteArray &flag : presetFlags) {
+    QVERIFY2(!flag.contains(' '), flag.constData());
+  }
+}
+
+void TestMemoryProfile::testResidentMemory() {
+  QTemporaryDir site;
+  QVERIFY(site.isValid());
+
+  FixtureServer server;
+  if (!server.start(site.path())) {
+    QSKIP("python3 is required to serve the test page");
+  }
+
+  // The page is served from localhost and the frames from 127.0.0.1, which
+  // Chromium puts in separate renderers unless the preset says otherwise
+  QByteArray page = "<!DOCTYPE html><html><body><h1>Memory</h1>";
+  for (int i = 0; i < 4; ++i) {
+    page += QString("<iframe src=\"%1\"></iframe>")
+                .arg(server.url(QString("frame.html?%1").arg(i)))
+                .toUtf8();
+  }
+  page += "</body></html>";
+
+  QFile index(site.filePath("index.html"));
+  QVERIFY(index.open(QIODevice::WriteOnly));
+  index.write(page);
+  index.close();
+
+  QFile frame(site.filePath("frame.html"));
+  QVERIFY(frame.open(QIODevice::WriteOnly));
+  frame.write("<!DOCTYPE html><html><body><script>"
+              "const data = new Array(1 << 18).fill(0).map((_, i) => ({i}));"
+              "document.body.textContent = data.length;"
+              "</script></body></html>");
+  frame.close();
+
+  QMap<QString, qint64> resident;
+  for (const QString &preset : {"low", "balanced", "performance"}) {
+    const QString url = server.url("index.html", "localhost");
+    WebAppRunner runner(WEBAPPCONTAINER_PATH);
+    QVERIFY(runner.start({"--profile", "memory-" + preset,
+                          "--memory-profile", preset, "--url", url}));
+    if (!runner.waitForEvent("firstLoadFinished", 60000)) {
+      QSKIP("webappcontainer could not load a page in this environment");
+    }
+    // An error page would make every preset look the same
+    QVERIFY2(runner.loaded(url),
+             qPrintable(preset + " did not load " + url));
+
+    // Let the frames finish their scripts and the renderers settle
+    QTest::qWait(2000);
+    resident.insert(preset, runner.residentKb());
+    qInfo().noquote() << QString("%1: %2 MiB resident in %3 processes")
+                             .arg(preset, 12)
+                             .arg(runner.residentKb() / 1024.0, 0, 'f', 1)
+                             .arg(runner.processCount());
+    runner.stop();
+  }
+
+  // Shared pages between processes are counted once per process, so the
+  // comparison leaves some room
+  QVERIFY(resident["low"] > 0);
+  QVERIFY2(resident["low"] <= resident["performance"] * 1.1,
+           qPrintable(QString("low %1 KiB, performance %2 KiB")
+                          .arg(resident["low"])
+                          .arg(resident["performance"])));
+}
+
+QTEST_GUILESS_MAIN(TestMemoryProfile)
+#include "tst_memoryprofile.moc"
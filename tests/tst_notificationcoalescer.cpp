@@ -0,0 +1,191 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QPointer>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <memory>
+
+#include "../notificationcoalescer.h"
+
+class TestNotificationCoalescer : public QObject {
+  Q_OBJECT
+
+private slots:
+  // Test that notifications under the limit are delivered right away
+  void testDelivered();
+
+  // Test that a burst is summarized at the end of the window
+  void testSummary();
+
+  // Test that the few left at the end of the window are delivered
+  void testDeliveredLater();
+
+  // Test that a notification with the same tag and origin replaces one,
+  // shown or waiting
+  void testSameTag();
+
+  // Test that notifications closed by their page are released
+  void testRemove();
+
+  // Test that only the last delivered notification is kept
+  void testReleased();
+
+private:
+  static std::unique_ptr<QObject> notification(const QString &name);
+  static void deleteReleased();
+
+  const QUrl m_origin = QUrl("https://chat.example.com");
+};
+
+std::unique_ptr<QObject> TestNotificationCoalescer::notification(
+    const QString &name) {
+  auto notification = std::make_unique<QObject>();
+  notification->setObjectName(name);
+  return notification;
+}
+
+void TestNotificationCoalescer::deleteReleased() {
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void TestNotificationCoalescer::testDelivered() {
+  NotificationCoalescer coalescer(2, 60000);
+  QSignalSpy delivered(&coalescer, &NotificationCoalescer::delivered);
+
+  coalescer.add(m_origin, QString(), notification("1"));
+  coalescer.add(m_origin, QString(), notification("2"));
+  QCOMPARE(delivered.size(), 2);
+  QCOMPARE(coalescer.current()->objectName(), QString("2"));
+
+  // Over the limit, so it waits
+  coalescer.add(m_origin, QString(), notification("3"));
+  QCOMPARE(delivered.size(), 2);
+  QCOMPARE(coalescer.pendingCount(), 1);
+
+  const NotificationCoalescer::Counters &counters = coalescer.counters();
+  QCOMPARE(counters.received, 3);
+  QCOMPARE(counters.delivered, 2);
+  QCOMPARE(counters.coalesced, 0);
+  QCOMPARE(counters.dropped, 0);
+}
+
+void TestNotificationCoalescer::testSummary() {
+  NotificationCoalescer coalescer(2, 100);
+  QSignalSpy delivered(&coalescer, &NotificationCoalescer::delivered);
+  QSignalSpy summarized(&coalescer, &NotificationCoalescer::summarized);
+
+  for (int i = 1; i <= 14; ++i) {
+    coalescer.add(m_origin, QString(), notification(QString::number(i)));
+  }
+  QCOMPARE(delivered.size(), 2);
+  QCOMPARE(coalescer.pendingCount(), 12);
+
+  QVERIFY(summarized.wait(1000));
+  QCOMPARE(summarized.size(), 1);
+  QCOMPARE(summarized[0][0].toInt(), 12);
+  QCOMPARE(summarized[0][1].value<QObject *>()->objectName(), QString("14"));
+  QCOMPARE(coalescer.current()->objectName(), QString("14"));
+  QCOMPARE(coalescer.pendingCount(), 0);
+
+  // The summary counts against the next window
+  coalescer.add(m_origin, QString(), notification("15"));
+  QCOMPARE(delivered.size(), 3);
+  coalescer.add(m_origin, QString(), notification("16"));
+  QCOMPARE(delivered.size(), 3);
+
+  const NotificationCoalescer::Counters &counters = coalescer.counters();
+  QCOMPARE(counters.received, 16);
+  QCOMPARE(counters.delivered, 3);
+  QCOMPARE(counters.dropped, 12);
+  QCOMPARE(counters.summaries, 1);
+}
+
+void TestNotificationCoalescer::testDeliveredLater() {
+  NotificationCoalescer coalescer(2, 100);
+  QSignalSpy delivered(&coalescer, &NotificationCoalescer::delivered);
+  QSignalSpy summarized(&coalescer, &NotificationCoalescer::summarized);
+
+  for (int i = 1; i <= 4; ++i) {
+    coalescer.add(m_origin, QString(), notification(QString::number(i)));
+  }
+  QCOMPARE(delivered.size(), 2);
+  QTRY_COMPARE(delivered.size(), 4);
+  QCOMPARE(delivered[2][0].value<QObject *>()->objectName(), QString("3"));
+  QCOMPARE(coalescer.current()->objectName(), QString("4"));
+  QCOMPARE(summarized.size(), 0);
+
+  // A quiet window resets the count
+  QTest::qWait(250);
+  coalescer.add(m_origin, QString(), notification("5"));
+  coalescer.add(m_origin, QString(), notification("6"));
+  QCOMPARE(delivered.size(), 6);
+}
+
+void TestNotificationCoalescer::testSameTag() {
+  NotificationCoalescer coalescer(1, 60000);
+  QSignalSpy delivered(&coalescer, &NotificationCoalescer::delivered);
+
+  // An update of the shown one replaces it right away, over the limit or not
+  coalescer.add(m_origin, "thread-1", notification("a"));
+  QCOMPARE(delivered.size(), 1);
+  QPointer<QObject> first = coalescer.current();
+  coalescer.add(m_origin, "thread-1", notification("b"));
+  QCOMPARE(delivered.size(), 2);
+  QCOMPARE(coalescer.current()->objectName(), QString("b"));
+  QCOMPARE(coalescer.pendingCount(), 0);
+  deleteReleased();
+  QVERIFY(!first);
+
+  // Updates of waiting ones replace them in place
+  coalescer.add(m_origin, "thread-2", notification("c"));
+  coalescer.add(m_origin, "thread-3", notification("d"));
+  coalescer.add(m_origin, "thread-2", notification("e"));
+  QCOMPARE(coalescer.pendingCount(), 2);
+
+  // Other origins and untagged ones are not
+  coalescer.add(QUrl("https://mail.example.com"), "thread-1",
+                notification("f"));
+  coalescer.add(m_origin, QString(), notification("g"));
+  coalescer.add(m_origin, QString(), notification("h"));
+  QCOMPARE(coalescer.pendingCount(), 5);
+
+  const NotificationCoalescer::Counters &counters = coalescer.counters();
+  QCOMPARE(counters.received, 8);
+  QCOMPARE(counters.delivered, 1);
+  QCOMPARE(counters.coalesced, 2);
+}
+
+void TestNotificationCoalescer::testRemove() {
+  NotificationCoalescer coalescer(1, 60000);
+  coalescer.add(m_origin, QString(), notification("a"));
+  coalescer.add(m_origin, QString(), notification("b"));
+  QPointer<QObject> shown = coalescer.current();
+  QCOMPARE(coalescer.pendingCount(), 1);
+
+  coalescer.remove(shown);
+  QVERIFY(!coalescer.current());
+  deleteReleased();
+  QVERIFY(!shown);
+
+  QObject unknown;
+  coalescer.remove(&unknown);
+  QCOMPARE(coalescer.pendingCount(), 1);
+}
+
+void TestNotificationCoalescer::testReleased() {
+  NotificationCoalescer coalescer(3, 60000);
+  coalescer.add(m_origin, QString(), notification("a"));
+  QPointer<QObject> first = coalescer.current();
+  coalescer.add(m_origin, QString(), notification("b"));
+  deleteReleased();
+  QVERIFY(!first);
+
+  std::unique_ptr<QObject> current = coalescer.takeCurrent();
+  QCOMPARE(current->objectName(), QString("b"));
+  QVERIFY(!coalescer.current());
+}
+
+QTEST_GUILESS_MAIN(TestNotificationCoalescer)
+#include "tst_notificationcoalescer.moc"
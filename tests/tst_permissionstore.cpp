@@ -0,0 +1,251 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <memory>
+
+#include "../permissionstore.h"
+#include "../settingsstore.h"
+
+using Type = QWebEnginePermission::PermissionType;
+
+class TestPermissionStore : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+
+  // Test that grants are indexed by origin and type
+  void testGrant();
+
+  // Test that lookups are answered from memory
+  void testLookupWithoutDisk();
+
+  // Test that grants are remembered by the next session
+  void testPersisted();
+
+  // Test that a grant is gone once it expires
+  void testExpiry();
+
+  // Test revoking one grant and all grants of an origin
+  void testRevoke();
+
+  // Test that grants are listed in order, without expired ones
+  void testListing();
+
+  // Test that the host-only keys of older versions keep covering every
+  // scheme and port of the host
+  void testLegacyKeys();
+
+private:
+  QString fileName() const { return m_dir->filePath("settings.ini"); }
+
+  std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+void TestPermissionStore::init() {
+  m_dir = std::make_unique<QTemporaryDir>();
+  QVERIFY(m_dir->isValid());
+}
+
+void TestPermissionStore::testGrant() {
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+
+  const QUrl origin("https://chat.example.com/channels/1");
+  QVERIFY(!store.isGranted(origin, Type::Notifications));
+
+  store.grant(origin, Type::Notifications);
+  QVERIFY(store.isGranted(origin, Type::Notifications));
+  QVERIFY(store.isGranted(QUrl("https://chat.example.com"),
+                          Type::Notifications));
+
+  // Other types, schemes, hosts and ports are other grants
+  QVERIFY(!store.isGranted(origin, Type::MediaAudioCapture));
+  QVERIFY(!store.isGranted(QUrl("http://chat.example.com"),
+                           Type::Notifications));
+  QVERIFY(!store.isGranted(QUrl("https://example.com"), Type::Notifications));
+  QVERIFY(!store.isGranted(QUrl("https://chat.example.com:8443"),
+                           Type::Notifications));
+
+  QCOMPARE(PermissionStore::originKey(QUrl("https://a.example:8443/x?y")),
+           QString("https://a.example:8443"));
+}
+
+void TestPermissionStore::testLookupWithoutDisk() {
+  {
+    SettingsStore settings(fileName());
+    PermissionStore store(&settings);
+    store.grant(QUrl("https://example.com"), Type::MediaVideoCapture);
+  }
+
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+  for (int i = 0; i < 10000; ++i) {
+    QVERIFY(store.isGranted(QUrl("https://example.com"),
+                            Type::MediaVideoCapture));
+  }
+  QVERIFY(settings.flush());
+  QCOMPARE(settings.fileParses(), 1);
+  QCOMPARE(settings.fileWrites(), 0);
+}
+
+void TestPermissionStore::testPersisted() {
+  const QDateTime expires = QDateTime::currentDateTimeUtc().addDays(30);
+  {
+    SettingsStore settings(fileName());
+    PermissionStore store(&settings);
+    store.grant(QUrl("https://example.com"), Type::MediaAudioCapture);
+    store.grant(QUrl("https://example.com"), Type::Geolocation, expires);
+  }
+
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+  QVERIFY(store.isGranted(QUrl("https://example.com"),
+                          Type::MediaAudioCapture));
+  QVERIFY(store.isGranted(QUrl("https://example.com"), Type::Geolocation));
+
+  const QList<PermissionStore::Grant> grants = store.grants();
+  QCOMPARE(grants.size(), 2);
+  QCOMPARE(grants[0].type, Type::MediaAudioCapture);
+  QVERIFY(!grants[0].expires.isValid());
+  QCOMPARE(grants[1].type, Type::Geolocation);
+  QCOMPARE(grants[1].expires.toMSecsSinceEpoch(),
+           expires.toMSecsSinceEpoch());
+}
+
+void TestPermissionStore::testExpiry() {
+  SettingsStore settings(fileName(), 60000);
+  PermissionStore store(&settings);
+
+  const QUrl origin("https://example.com");
+  store.grant(origin, Type::ClipboardReadWrite,
+              QDateTime::currentDateTime().addSecs(-1));
+  QVERIFY(!store.isGranted(origin, Type::ClipboardReadWrite));
+  QVERIFY(settings.keys("Permissions/").isEmpty());
+
+  // Expired grants are dropped without being asked for
+  store.grant(origin, Type::Notifications,
+              QDateTime::currentDateTime().addMSecs(200));
+  QVERIFY(store.isGranted(origin, Type::Notifications));
+  QCOMPARE(settings.keys("Permissions/").size(), 1);
+  QTRY_VERIFY_WITH_TIMEOUT(settings.keys("Permissions/").isEmpty(), 5000);
+  QVERIFY(store.grants().isEmpty());
+
+  // Expired grants are not loaded
+  store.grant(origin, Type::Geolocation,
+              QDateTime::currentDateTime().addMSecs(100));
+  QVERIFY(settings.flush());
+  QTest::qWait(200);
+  SettingsStore next(fileName());
+  PermissionStore nextStore(&next);
+  QVERIFY(!nextStore.isGranted(origin, Type::Geolocation));
+  QVERIFY(next.keys("Permissions/").isEmpty());
+}
+
+void TestPermissionStore::testRevoke() {
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+
+  const QUrl origin("https://example.com");
+  store.grant(origin, Type::Notifications);
+  store.grant(origin, Type::MediaAudioCapture);
+  store.grant(origin, Type::MediaVideoCapture);
+  store.grant(QUrl("https://example.org"), Type::Notifications);
+
+  store.revoke(origin, Type::Notifications);
+  QVERIFY(!store.isGranted(origin, Type::Notifications));
+  QVERIFY(store.isGranted(origin, Type::MediaAudioCapture));
+
+  QCOMPARE(store.revokeOrigin(QUrl("https://example.com/page")), 2);
+  QVERIFY(store.grantsForOrigin(origin).isEmpty());
+  QVERIFY(store.isGranted(QUrl("https://example.org"), Type::Notifications));
+  QCOMPARE(settings.keys("Permissions/").size(), 1);
+}
+
+void TestPermissionStore::testListing() {
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+
+  store.grant(QUrl("https://b.example"), Type::Notifications);
+  store.grant(QUrl("https://a.example"), Type::Notifications);
+  store.grant(QUrl("https://a.example"), Type::Geolocation);
+  store.grant(QUrl("https://c.example"), Type::Notifications,
+              QDateTime::currentDateTime().addSecs(-1));
+
+  const QList<PermissionStore::Grant> grants = store.grants();
+  QCOMPARE(grants.size(), 3);
+  QCOMPARE(grants[0].origin, QString("https://a.example"));
+  QCOMPARE(grants[0].type, Type::Notifications);
+  QCOMPARE(grants[1].origin, QString("https://a.example"));
+  QCOMPARE(grants[1].type, Type::Geolocation);
+  QCOMPARE(grants[2].origin, QString("https://b.example"));
+
+  QCOMPARE(store.grantsForOrigin(QUrl("https://a.example")).size(), 2);
+  QCOMPARE(store.removeExpired(), 1);
+}
+
+void TestPermissionStore::testLegacyKeys() {
+  {
+    QSettings settings(fileName(), QSettings::IniFormat);
+    settings.beginGroup("Permissions");
+    settings.setValue("grants/web_example_com/7", true);
+    settings.setValue("grants/app_example_net/2", true);
+    settings.setValue("grants/example_org/2", false);
+    settings.setValue("ProtocolHandlers/example.com/mailto", true);
+    settings.endGroup();
+  }
+
+  {
+    SettingsStore settings(fileName());
+    PermissionStore store(&settings);
+
+    // The old keys held only the host, the grant covers any scheme and port
+    QVERIFY(store.isGranted(QUrl("https://web.example.com"),
+                            Type::Notifications));
+    QVERIFY(store.isGranted(QUrl("http://web.example.com"),
+                            Type::Notifications));
+    QVERIFY(store.isGranted(QUrl("http://app.example.net:8080/call"),
+                            Type::MediaVideoCapture));
+    QVERIFY(store.isGranted(QUrl("https://app.example.net"),
+                            Type::MediaVideoCapture));
+    QVERIFY(!store.isGranted(QUrl("http://app.example.net:8080"),
+                             Type::MediaAudioCapture));
+    QVERIFY(!store.isGranted(QUrl("https://other.example.net"),
+                             Type::MediaVideoCapture));
+    QVERIFY(!store.isGranted(QUrl("https://example.org"),
+                             Type::MediaVideoCapture));
+
+    const QList<PermissionStore::Grant> grants = store.grants();
+    QCOMPARE(grants.size(), 2);
+    QCOMPARE(grants[0].origin, QString("app.example.net"));
+    QCOMPARE(grants[1].origin, QString("web.example.com"));
+    QCOMPARE(store.grantsForOrigin(QUrl("http://web.example.com:81")).size(),
+             1);
+
+    // The old keys are gone, other permissions are left alone
+    QVERIFY(settings.keys("Permissions/grants/").isEmpty());
+    QVERIFY(
+        settings.contains("Permissions/ProtocolHandlers/example.com/mailto"));
+  }
+
+  // Still host wide in the next session, until revoked through any origin
+  // of the host
+  SettingsStore settings(fileName());
+  PermissionStore store(&settings);
+  QVERIFY(store.isGranted(QUrl("http://web.example.com:3000"),
+                          Type::Notifications));
+  store.revoke(QUrl("http://app.example.net:8080"), Type::MediaVideoCapture);
+  QVERIFY(!store.isGranted(QUrl("https://app.example.net"),
+                           Type::MediaVideoCapture));
+  QCOMPARE(store.revokeOrigin(QUrl("https://web.example.com")), 1);
+  QVERIFY(!store.isGranted(QUrl("http://web.example.com"),
+                           Type::Notifications));
+  QVERIFY(settings.keys("Permissions/granted/").isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestPermissionStore)
+#include "tst_permissionstore.moc"
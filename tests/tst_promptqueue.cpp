@@ -0,0 +1,196 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QMessageBox>
+#include <QPointer>
+#include <QPushButton>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#include "../promptqueue.h"
+
+class TestPromptQueue : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+  void cleanup();
+
+  // Test that asking returns right away and the event loop keeps running
+  // while the prompt is open
+  void testNonBlocking();
+
+  // Test that a request like one that is waiting is answered with it
+  void testDuplicates();
+
+  // Test that prompts are shown one at a time, in order
+  void testOrder();
+
+  // Test that the result of a custom dialog is passed on
+  void testCustomDialog();
+
+  // Test that a blocked event loop shows up in the latency
+  void testLatency();
+
+  // Test that open prompts go away with the queue, without answers
+  void testDestroyed();
+
+private:
+  static void answer(PromptQueue *queue, QMessageBox::StandardButton button);
+
+  QWidget *m_window = nullptr;
+  PromptQueue *m_queue = nullptr;
+};
+
+void TestPromptQueue::init() {
+  m_window = new QWidget;
+  m_window->resize(400, 300);
+  m_window->show();
+  QVERIFY(QTest::qWaitForWindowExposed(m_window));
+  m_queue = new PromptQueue(m_window);
+}
+
+void TestPromptQueue::cleanup() {
+  delete m_window;
+  m_window = nullptr;
+  m_queue = nullptr;
+}
+
+void TestPromptQueue::answer(PromptQueue *queue,
+                             QMessageBox::StandardButton button) {
+  auto *box = qobject_cast<QMessageBox *>(queue->currentDialog());
+  QVERIFY(box);
+  box->button(button)->click();
+}
+
+void TestPromptQueue::testNonBlocking() {
+  int answers = 0;
+  bool accepted = false;
+  m_queue->question("https://example.com\n7", "Permission Request",
+                    "Allow example.com to show notifications?",
+                    [&](bool yes) {
+                      ++answers;
+                      accepted = yes;
+                    });
+  QCOMPARE(answers, 0);
+
+  QDialog *dialog = m_queue->currentDialog();
+  QVERIFY(dialog);
+  QCOMPARE(dialog->windowModality(), Qt::WindowModal);
+  QCOMPARE(dialog->parentWidget(), m_window);
+  QTRY_VERIFY(dialog->isVisible());
+
+  int ticks = 0;
+  QTimer timer;
+  connect(&timer, &QTimer::timeout, [&ticks]() { ++ticks; });
+  timer.start(10);
+  QTest::qWait(300);
+  QVERIFY2(ticks >= 10, qPrintable(QString::number(ticks)));
+
+  answer(m_queue, QMessageBox::Yes);
+  QCOMPARE(answers, 1);
+  QVERIFY(accepted);
+  QCOMPARE(m_queue->size(), 0);
+  QVERIFY(!m_queue->currentDialog());
+}
+
+void TestPromptQueue::testDuplicates() {
+  QList<bool> first;
+  QList<bool> second;
+  for (int i = 0; i < 3; ++i) {
+    m_queue->question("a", "Title", "Question?",
+                      [&first](bool yes) { first.append(yes); });
+  }
+  m_queue->question("b", "Title", "Question?",
+                    [&second](bool yes) { second.append(yes); });
+  QCOMPARE(m_queue->size(), 2);
+  QVERIFY(m_queue->contains("a"));
+
+  answer(m_queue, QMessageBox::No);
+  QCOMPARE(first, QList<bool>({false, false, false}));
+  QVERIFY(second.isEmpty());
+  QVERIFY(!m_queue->contains("a"));
+
+  // Asked again once answered
+  m_queue->question("a", "Title", "Question?",
+                    [&first](bool yes) { first.append(yes); });
+  QCOMPARE(m_queue->size(), 2);
+
+  answer(m_queue, QMessageBox::Yes);
+  QCOMPARE(second, QList<bool>({true}));
+  answer(m_queue, QMessageBox::Yes);
+  QCOMPARE(first.size(), 4);
+  QVERIFY(first.last());
+}
+
+void TestPromptQueue::testOrder() {
+  QStringList order;
+  for (const QString &key : {"a", "b", "c"}) {
+    m_queue->question(key, key, "Question?", [&order, key, this](bool) {
+      order.append(key);
+      // Asking from a callback goes to the back of the queue
+      if (key == "a") {
+        m_queue->question("d", "d", "Question?",
+                          [&order](bool) { order.append("d"); });
+      }
+    });
+  }
+
+  while (m_queue->currentDialog()) {
+    answer(m_queue, QMessageBox::No);
+  }
+  QCOMPARE(order, QStringList({"a", "b", "c", "d"}));
+}
+
+void TestPromptQueue::testCustomDialog() {
+  QList<bool> answers;
+  auto factory = [](QWidget *parent) { return new QDialog(parent); };
+  m_queue->ask("accept", factory,
+               [&answers](bool yes) { answers.append(yes); });
+  m_queue->ask("reject", factory,
+               [&answers](bool yes) { answers.append(yes); });
+
+  m_queue->currentDialog()->accept();
+  m_queue->currentDialog()->reject();
+  QCOMPARE(answers, QList<bool>({true, false}));
+
+  // Closing the window is a no
+  m_queue->ask("close", factory,
+               [&answers](bool yes) { answers.append(yes); });
+  QTRY_VERIFY(m_queue->currentDialog()->isVisible());
+  m_queue->currentDialog()->close();
+  QCOMPARE(answers.last(), false);
+}
+
+void TestPromptQueue::testLatency() {
+  m_queue->question("a", "Title", "Question?", [](bool) {});
+  QTest::qWait(200);
+  const qint64 idleLatencyMs = m_queue->maxEventLoopLatencyMs();
+
+  QTimer::singleShot(0, []() { QThread::msleep(300); });
+  QTRY_VERIFY2(m_queue->maxEventLoopLatencyMs() >= 200,
+               qPrintable(QString::number(m_queue->maxEventLoopLatencyMs())));
+  QVERIFY(m_queue->maxEventLoopLatencyMs() > idleLatencyMs);
+  qInfo() << "Event loop latency with a prompt open:" << idleLatencyMs
+          << "ms";
+}
+
+void TestPromptQueue::testDestroyed() {
+  int answers = 0;
+  m_queue->question("a", "Title", "Question?", [&answers](bool) { ++answers; });
+  m_queue->question("b", "Title", "Question?", [&answers](bool) { ++answers; });
+  QPointer<QDialog> dialog = m_queue->currentDialog();
+  QVERIFY(dialog);
+
+  delete m_queue;
+  m_queue = nullptr;
+  QVERIFY(!dialog);
+  QCoreApplication::processEvents();
+  QCOMPARE(answers, 0);
+}
+
+QTEST_MAIN(TestPromptQueue)
+#include "tst_promptqueue.moc"
@@ -0,0 +1,291 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../publicsuffixlist.h"
+
+using namespace Qt::StringLiterals;
+
+// Count heap allocations made by the current thread while counting is enabled
+static thread_local bool s_countAllocations = false;
+static std::atomic<int> s_allocations{0};
+
+void *operator new(std::size_t size) {
+  if (s_countAllocations) {
+    ++s_allocations;
+  }
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+class TestPublicSuffixList : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+
+  // Test registrable domain lookup for normal, wildcard and exception rules
+  void testBaseDomain_data();
+  void testBaseDomain();
+
+  // Test same-site comparison used for popup routing
+  void testIsSameDomain_data();
+  void testIsSameDomain();
+
+  // Test that lookups on ASCII hosts don't touch the heap
+  void testLookupDoesNotAllocate();
+
+  // Test that a valid snapshot is swapped in and a corrupt one is ignored.
+  // This and the following tests replace the loaded list, so they run last.
+  void testLoadSnapshot();
+
+  // Test lookups from several threads while reloads swap the table
+  void testConcurrentReload();
+
+private:
+  static QString writeSnapshot(const QString &path,
+                               std::initializer_list<std::u16string_view> rules);
+};
+
+void TestPublicSuffixList::initTestCase() {
+  // Keep a snapshot from update-psl in the user's cache out of the test
+  QStandardPaths::setTestModeEnabled(true);
+
+  // Load on a worker thread, the same way the application does
+  QFuture<void> loading = PublicSuffixList::loadAsync();
+  loading.waitForFinished();
+  QVERIFY(PublicSuffixList::isReady());
+  QVERIFY(PublicSuffixList::instance() != nullptr);
+}
+
+void TestPublicSuffixList::testBaseDomain_data() {
+  QTest::addColumn<QString>("host");
+  QTest::addColumn<QString>("baseDomain");
+
+  // Single labels and unknown TLDs
+  QTest::newRow("single label") << "localhost" << "localhost";
+  QTest::newRow("unknown tld") << "www.example.unknowntld"
+                               << "example.unknowntld";
+
+  // Normal rules
+  QTest::newRow("tld") << "com" << "com";
+  QTest::newRow("registrable") << "example.com" << "example.com";
+  QTest::newRow("subdomain") << "www.example.com" << "example.com";
+  QTest::newRow("deep subdomain") << "a.b.c.d.example.com" << "example.com";
+  QTest::newRow("two label suffix") << "www.example.co.uk" << "example.co.uk";
+  QTest::newRow("suffix only") << "co.uk" << "co.uk";
+  QTest::newRow("uppercase") << "WWW.Example.CO.UK" << "example.co.uk";
+
+  // Wildcard "*.ck" and exception "!www.ck"
+  QTest::newRow("wildcard") << "a.b.ck" << "a.b.ck";
+  QTest::newRow("wildcard subdomain") << "x.a.b.ck" << "a.b.ck";
+  QTest::newRow("exception") << "www.ck" << "www.ck";
+  QTest::newRow("exception subdomain") << "foo.www.ck" << "www.ck";
+
+  // Wildcard "*.kawasaki.jp" and exception "!city.kawasaki.jp"
+  QTest::newRow("wildcard jp") << "a.b.kawasaki.jp" << "a.b.kawasaki.jp";
+  QTest::newRow("exception jp") << "a.city.kawasaki.jp" << "city.kawasaki.jp";
+
+  // Rules outside of ASCII
+  QTest::newRow("idn suffix") << u"www.example.公司.cn"_s
+                              << u"example.公司.cn"_s;
+}
+
+void TestPublicSuffixList::testBaseDomain() {
+  QFETCH(QString, host);
+  QFETCH(QString, baseDomain);
+
+  PublicSuffixList *psl = PublicSuffixList::instance();
+  QCOMPARE(psl->getBaseDomain(host), baseDomain);
+
+  // The view variant must point into the input
+  const QStringView view = psl->baseDomain(host);
+  QCOMPARE(view.toString().toLower(), baseDomain);
+  QCOMPARE(view.data() + view.size(), host.constData() + host.size());
+}
+
+void TestPublicSuffixList::testIsSameDomain_data() {
+  QTest::addColumn<QString>("host1");
+  QTest::addColumn<QString>("host2");
+  QTest::addColumn<bool>("same");
+
+  QTest::newRow("same host") << "example.com" << "example.com" << true;
+  QTest::newRow("subdomains") << "mail.google.com" << "accounts.google.com"
+                              << true;
+  QTest::newRow("case") << "Mail.Google.com" << "accounts.google.COM" << true;
+  QTest::newRow("different") << "google.com" << "example.com" << false;
+  QTest::newRow("shared suffix") << "a.co.uk" << "b.co.uk" << false;
+  QTest::newRow("wildcard") << "x.a.b.ck" << "y.c.b.ck" << false;
+}
+
+void TestPublicSuffixList::testIsSameDomain() {
+  QFETCH(QString, host1);
+  QFETCH(QString, host2);
+  QFETCH(bool, same);
+
+  QCOMPARE(PublicSuffixList::instance()->isSameDomain(host1, host2), same);
+}
+
+void TestPublicSuffixList::testLookupDoesNotAllocate() {
+  PublicSuffixList *psl = PublicSuffixList::instance();
+
+  const QStringView hosts[] = {
+      u"localhost",          u"example.com",        u"www.example.co.uk",
+      u"WWW.EXAMPLE.CO.UK",  u"a.b.c.d.example.com", u"x.a.b.ck",
+      u"foo.www.ck",         u"a.city.kawasaki.jp", u"example.unknowntld",
+  };
+
+  qsizetype total = 0;
+  s_allocations = 0;
+  s_countAllocations = true;
+  for (QStringView host : hosts) {
+    total += psl->baseDomainOffset(host);
+    total += psl->isSameDomain(host, u"mail.example.com") ? 1 : 0;
+  }
+  s_countAllocations = false;
+
+  QVERIFY(total > 0);
+  QCOMPARE(s_allocations.load(), 0);
+}
+
+QString TestPublicSuffixList::writeSnapshot(
+    const QString &path, std::initializer_list<std::u16string_view> rules) {
+  psl::TableBuilder builder;
+  for (std::u16string_view rule : rules) {
+    builder.addRule(rule);
+  }
+  const std::string snapshot =
+      psl::writeSnapshot(builder.build(), "9999-12-31_23-59-59_UTC");
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return QString();
+  }
+  file.write(snapshot.data(), qint64(snapshot.size()));
+  return path;
+}
+
+void TestPublicSuffixList::testLoadSnapshot() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  // A tiny list in which "test" is a public suffix
+  const QString path = writeSnapshot(dir.filePath("public_suffix_list.bin"),
+                                     {u"test", u"*.example.test"});
+  QVERIFY(!path.isEmpty());
+
+  PublicSuffixList *psl = PublicSuffixList::instance();
+  QVERIFY(psl->loadSnapshot(path));
+  QCOMPARE(psl->getBaseDomain("www.a.test"), "a.test");
+  QCOMPARE(psl->getBaseDomain("www.a.example.test"), "www.a.example.test");
+  QCOMPARE(psl->getBaseDomain("www.example.co.uk"), "co.uk");
+
+  // The loaded snapshot is mapped, so damaged copies go to other files
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  QByteArray data = file.readAll();
+  file.close();
+
+  // Flip a byte in the label pool: the checksum no longer matches
+  QByteArray corrupt = data;
+  corrupt[corrupt.size() - 1] = 'x';
+  QFile corruptFile(dir.filePath("corrupt.bin"));
+  QVERIFY(corruptFile.open(QIODevice::WriteOnly));
+  corruptFile.write(corrupt);
+  corruptFile.close();
+
+  QVERIFY(!psl->loadSnapshot(corruptFile.fileName()));
+  QCOMPARE(psl->getBaseDomain("www.a.test"), "a.test");
+
+  // Truncated files are rejected as well
+  QFile truncatedFile(dir.filePath("truncated.bin"));
+  QVERIFY(truncatedFile.open(QIODevice::WriteOnly));
+  truncatedFile.write(data.left(64));
+  truncatedFile.close();
+
+  QVERIFY(!psl->loadSnapshot(truncatedFile.fileName()));
+
+  // Missing files too
+  QVERIFY(!psl->loadSnapshot(dir.filePath("missing.bin")));
+}
+
+void TestPublicSuffixList::testConcurrentReload() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  // Under the first list www.a.test belongs to a.test, under the second one
+  // to itself
+  const QString first =
+      writeSnapshot(dir.filePath("first.bin"), {u"test"});
+  const QString second =
+      writeSnapshot(dir.filePath("second.bin"), {u"test", u"a.test"});
+  QVERIFY(!first.isEmpty() && !second.isEmpty());
+
+  PublicSuffixList *psl = PublicSuffixList::instance();
+  QVERIFY(psl->loadSnapshot(first));
+
+  const int threadCount = qMax(4, QThread::idealThreadCount());
+  std::atomic<bool> stop{false};
+  std::atomic<int> lookups{0};
+  std::atomic<int> failures{0};
+
+  std::vector<std::unique_ptr<QThread>> threads;
+  for (int i = 0; i < threadCount; ++i) {
+    threads.emplace_back(QThread::create([&]() {
+      const QStringView host = u"www.a.test";
+      while (!stop.load(std::memory_order_relaxed)) {
+        const QStringView base = psl->baseDomain(host);
+        if (base != QStringView(u"a.test") &&
+            base != QStringView(u"www.a.test")) {
+          ++failures;
+        }
+        if (!psl->isSameDomain(u"x.b.test", u"y.b.test")) {
+          ++failures;
+        }
+        ++lookups;
+      }
+    }));
+    threads.back()->start();
+  }
+
+  // Swap the tables back and forth while the readers are running. Failures
+  // are only checked once the readers are joined, returning early would
+  // destroy threads that are still running.
+  int reloadFailures = 0;
+  for (int i = 0; i < 100; ++i) {
+    if (!psl->loadSnapshot(i % 2 ? first : second)) {
+      ++reloadFailures;
+    }
+    QThread::msleep(1);
+  }
+
+  stop = true;
+  bool joined = true;
+  for (const auto &thread : threads) {
+    joined = thread->wait(10000) && joined;
+  }
+
+  QVERIFY(joined);
+  QCOMPARE(reloadFailures, 0);
+  QVERIFY(lookups.load() > 0);
+  QCOMPARE(failures.load(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestPublicSuffixList)
+#include "tst_publicsuffixlist.moc"
@@ -0,0 +1,152 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+#include "../readahead.h"
+
+class TestReadahead : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+
+  // Test that the files the process has open or opens under the profile
+  // are recorded, also briefly and in new directories, and nothing outside
+  // of it
+  void testRecord();
+
+  // Test that the recorded files are read ahead within the byte budget
+  void testBudget();
+
+  // Test that a cancelled read ahead stops early
+  void testCancel();
+
+  // Test that a list can't point outside of the profile
+  void testListOutsideProfile();
+
+private:
+  bool writeFile(const QString &path, qint64 size);
+
+  QTemporaryDir m_profile;
+  QTemporaryDir m_outside;
+};
+
+void TestReadahead::initTestCase() {
+#ifndef Q_OS_LINUX
+  QSKIP("Read ahead is only implemented on Linux");
+#endif
+  QVERIFY(m_profile.isValid());
+  QVERIFY(m_outside.isValid());
+  QVERIFY(QDir(m_profile.path()).mkpath("cache/Cache_Data"));
+}
+
+bool TestReadahead::writeFile(const QString &path, qint64 size) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  return file.write(QByteArray(size, 'x')) == size;
+}
+
+void TestReadahead::testRecord() {
+  const QStringList inside = {"Cookies", "Local Storage.db",
+                              "cache/Cache_Data/index", "cache/Cache_Data/a_0"};
+  for (const QString &name : inside) {
+    QVERIFY(writeFile(m_profile.filePath(name), 64 * 1024));
+  }
+  QVERIFY(writeFile(m_outside.filePath("elsewhere"), 1024));
+
+  // Chromium holds databases open, cache entries only while reading them
+  std::vector<std::unique_ptr<QFile>> open;
+  for (const QString &path :
+       {m_profile.filePath(inside[0]), m_profile.filePath(inside[1]),
+        m_outside.filePath("elsewhere")}) {
+    open.push_back(std::make_unique<QFile>(path));
+    QVERIFY(open.back()->open(QIODevice::ReadOnly));
+  }
+
+  {
+    Readahead readahead(m_profile.path());
+    QVERIFY(readahead.files().isEmpty());
+    readahead.record(1000);
+
+    QTest::qWait(200);
+    QFile entry(m_profile.filePath(inside[2]));
+    QVERIFY(entry.open(QIODevice::ReadOnly));
+    entry.close();
+
+    // Created while recording, in a directory that didn't exist before
+    QVERIFY(QDir(m_profile.path()).mkpath("Service Worker/Database"));
+    QVERIFY(writeFile(m_profile.filePath("Service Worker/Database/LOG"),
+                      64 * 1024));
+
+    QTRY_VERIFY(QFile::exists(m_profile.filePath("readahead.txt")));
+  }
+
+  // The files open already come first, then the rest in the order they were
+  // opened
+  Readahead next(m_profile.path());
+  QStringList recorded = next.files();
+  QStringList expected = inside.mid(0, 3) << "Service Worker/Database/LOG";
+  recorded.sort();
+  expected.sort();
+  QCOMPARE(recorded, expected);
+}
+
+void TestReadahead::testBudget() {
+  // The list from testRecord, 64 KiB per file
+  Readahead readahead(m_profile.path());
+  QCOMPARE(readahead.files().size(), 4);
+
+  QFuture<Readahead::Result> reading = readahead.start(100 * 1024);
+  QVERIFY(reading.isValid());
+  reading.waitForFinished();
+  const Readahead::Result result = reading.result();
+  QCOMPARE(result.bytes, 100 * 1024);
+  QCOMPARE(result.files, 2);
+  QVERIFY(!result.cancelled);
+
+  // Missing files are skipped
+  QVERIFY(QFile::remove(m_profile.filePath("Cookies")));
+  Readahead unbounded(m_profile.path());
+  reading = unbounded.start();
+  reading.waitForFinished();
+  QCOMPARE(reading.result().files, 3);
+  QCOMPARE(reading.result().bytes, 3 * 64 * 1024);
+}
+
+void TestReadahead::testCancel() {
+  Readahead readahead(m_profile.path());
+  QFuture<Readahead::Result> reading = readahead.start();
+  readahead.cancel();
+  reading.waitForFinished();
+
+  // The worker may have finished before the cancel, but never reads more
+  const Readahead::Result result = reading.result();
+  QVERIFY(result.cancelled || result.files == 3);
+  QVERIFY(result.bytes <= 3 * 64 * 1024);
+}
+
+void TestReadahead::testListOutsideProfile() {
+  QTemporaryDir profile;
+  QVERIFY(profile.isValid());
+
+  QFile list(profile.filePath("readahead.txt"));
+  QVERIFY(list.open(QIODevice::WriteOnly));
+  list.write(QFile::encodeName(m_outside.filePath("elsewhere")) + "\n" +
+             "../elsewhere\n" + "Cookies\n");
+  list.close();
+
+  Readahead readahead(profile.path());
+  QCOMPARE(readahead.files(), QStringList{"Cookies"});
+}
+
+QTEST_GUILESS_MAIN(TestReadahead)
+#include "tst_readahead.moc"
@@ -0,0 +1,415 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QScopeGuard>
+#include <QSemaphore>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+#include "../settingsstore.h"
+
+class TestSettingsStore : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+
+  // Test that the file is parsed once, however often it is read
+  void testParsedOnce();
+
+  // Test that a burst of changes is written once, within the delay
+  void testCoalesced();
+
+  // Test that changes made while a write is in flight are written after it,
+  // and that changes after that are still coalesced
+  void testBusyRetry();
+
+  // Test that the file keeps the QSettings format and keys
+  void testFormat();
+
+  // Test that flush writes right away, and nothing when nothing changed
+  void testFlush();
+
+  // Test that pending changes are written when the store goes away
+  void testDestructorFlushes();
+
+  // Test that removed keys are gone from the file
+  void testRemove();
+
+  // Test that every profile has one store
+  void testForProfile();
+
+  // Test that changes are in the journal before they are compacted
+  void testJournal();
+
+  // Test that a record cut short is dropped, and the ones before it kept
+  void testTornJournal();
+
+  // Test that a journal past its limit is compacted right away, and that
+  // the change after that still waits for the delay
+  void testJournalLimit();
+
+  // Test that no change is lost or half applied when the process is killed
+  // at random points, compacting included
+  void testCrashRecovery();
+
+private:
+  QString fileName() const { return m_dir->filePath("settings.ini"); }
+
+  std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+void TestSettingsStore::init() {
+  m_dir = std::make_unique<QTemporaryDir>();
+  QVERIFY(m_dir->isValid());
+}
+
+void TestSettingsStore::testParsedOnce() {
+  {
+    QSettings settings(fileName(), QSettings::IniFormat);
+    settings.setValue("Behavior/hideOnClose", false);
+    settings.setValue("Permissions/grants/example_com/7", true);
+  }
+
+  SettingsStore store(fileName());
+  for (int i = 0; i < 1000; ++i) {
+    QCOMPARE(store.value("Behavior/hideOnClose", true).toBool(), false);
+    QVERIFY(store.value("Permissions/grants/example_com/7").toBool());
+    QVERIFY(!store.contains("Permissions/grants/example_org/7"));
+  }
+  QCOMPARE(store.fileParses(), 1);
+  QCOMPARE(store.fileWrites(), 0);
+
+  // Nothing to parse in a new profile
+  SettingsStore empty(m_dir->filePath("missing.ini"));
+  QCOMPARE(empty.fileParses(), 0);
+}
+
+void TestSettingsStore::testCoalesced() {
+  const int delayMs = 200;
+  SettingsStore store(fileName(), delayMs);
+
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < 100; ++i) {
+    store.setValue("Behavior/hideOnMinimize", i % 2 == 0);
+    store.setValue(QString("Permissions/grants/host%1/7").arg(i), true);
+  }
+  QVERIFY(!QFile::exists(fileName()));
+
+  QTRY_COMPARE_WITH_TIMEOUT(store.fileWrites(), 1, 5000);
+  QVERIFY(timer.elapsed() >= delayMs);
+
+  // The values in memory are the latest ones
+  QCOMPARE(store.value("Behavior/hideOnMinimize").toBool(), false);
+
+  // No more writes without more changes
+  QTest::qWait(delayMs * 2);
+  QCOMPARE(store.fileWrites(), 1);
+  QCOMPARE(store.fileParses(), 0);
+
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QCOMPARE(settings.value("Behavior/hideOnMinimize").toBool(), false);
+  QCOMPARE(settings.allKeys().size(), 101);
+}
+
+void TestSettingsStore::testBusyRetry() {
+  const int delayMs = 300;
+  SettingsStore store(fileName(), delayMs);
+
+  // Every pool thread waits on hold, so a write stays in flight until then
+  QThreadPool *pool = QThreadPool::globalInstance();
+  const int threads = pool->maxThreadCount();
+  QSemaphore hold;
+  auto release = qScopeGuard([&]() {
+    hold.release(threads);
+    pool->waitForDone();
+  });
+  for (int i = 0; i < threads; ++i) {
+    pool->start([&hold]() { hold.acquire(); });
+  }
+
+  store.setValue("Behavior/hideOnClose", false);
+  QTest::qWait(delayMs + 100);
+  store.setValue("Behavior/hideOnClose", true);
+  // Due while the first write is still queued, so it is retried
+  QTest::qWait(delayMs + 100);
+  QCOMPARE(store.fileWrites(), 0);
+  release.dismiss();
+  hold.release(threads);
+  QTRY_COMPARE_WITH_TIMEOUT(store.fileWrites(), 2, 5000);
+
+  // The retry did not shorten the delay
+  store.setValue("Behavior/hideOnMinimize", true);
+  store.setValue("Behavior/hideOnMinimize", false);
+  QTest::qWait(delayMs / 2);
+  QCOMPARE(store.fileWrites(), 2);
+  QTRY_COMPARE_WITH_TIMEOUT(store.fileWrites(), 3, 5000);
+
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QVERIFY(settings.value("Behavior/hideOnClose").toBool());
+  QCOMPARE(settings.value("Behavior/hideOnMinimize", true).toBool(), false);
+}
+
+void TestSettingsStore::testFormat() {
+  const QByteArray geometry("\x01\xd9\xd0\xcb\x00\x03", 6);
+  {
+    SettingsStore store(fileName());
+    store.setValue("BrowserWindow/geometry", geometry);
+    store.setValue("Behavior/hideOnClose", false);
+    store.setValue("Permissions/ProtocolHandlers/example.com/mailto", true);
+  }
+
+  QSettings settings(fileName(), QSettings::IniFormat);
+  settings.beginGroup("BrowserWindow");
+  QCOMPARE(settings.value("geometry").toByteArray(), geometry);
+  settings.endGroup();
+  QCOMPARE(settings.value("Behavior/hideOnClose", true).toBool(), false);
+  QVERIFY(
+      settings.value("Permissions/ProtocolHandlers/example.com/mailto")
+          .toBool());
+
+  // And reads back what it wrote
+  SettingsStore store(fileName());
+  QCOMPARE(store.value("BrowserWindow/geometry").toByteArray(), geometry);
+  QCOMPARE(store.value("Behavior/hideOnClose", true).toBool(), false);
+}
+
+void TestSettingsStore::testFlush() {
+  SettingsStore store(fileName(), 60000);
+  QVERIFY(store.flush());
+  QCOMPARE(store.fileWrites(), 0);
+
+  store.setValue("Behavior/hideOnClose", false);
+  // Setting a value it already has is not a change
+  store.setValue("Behavior/hideOnClose", false);
+  QVERIFY(store.flush(5000));
+  QCOMPARE(store.fileWrites(), 1);
+  QVERIFY(QFile::exists(fileName()));
+  QVERIFY(!QFile::exists(fileName() + ".new"));
+
+  store.setValue("Behavior/hideOnClose", false);
+  QVERIFY(store.flush(5000));
+  QCOMPARE(store.fileWrites(), 1);
+
+  // Every flush with changes is one write
+  store.setValue("Behavior/hideOnClose", true);
+  QVERIFY(store.flush(5000));
+  store.setValue("Behavior/hideOnMinimize", true);
+  QVERIFY(store.flush(5000));
+  QCOMPARE(store.fileWrites(), 3);
+
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QVERIFY(settings.value("Behavior/hideOnClose").toBool());
+  QVERIFY(settings.value("Behavior/hideOnMinimize").toBool());
+}
+
+void TestSettingsStore::testDestructorFlushes() {
+  {
+    SettingsStore store(fileName(), 60000);
+    store.setValue("Behavior/hideOnMinimize", true);
+  }
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QVERIFY(settings.value("Behavior/hideOnMinimize").toBool());
+}
+
+void TestSettingsStore::testRemove() {
+  SettingsStore store(fileName(), 60000);
+  store.setValue("Permissions/grants/example_com/7", true);
+  store.setValue("Permissions/grants/example_com/8", true);
+  store.setValue("Behavior/hideOnClose", false);
+  QCOMPARE(store.keys("Permissions/").size(), 2);
+
+  store.remove("Permissions/grants/example_com/7");
+  QVERIFY(!store.contains("Permissions/grants/example_com/7"));
+  QCOMPARE(store.keys("Permissions/"),
+           QStringList{"Permissions/grants/example_com/8"});
+  QVERIFY(store.flush(5000));
+
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QVERIFY(!settings.contains("Permissions/grants/example_com/7"));
+  QVERIFY(settings.contains("Permissions/grants/example_com/8"));
+}
+
+void TestSettingsStore::testForProfile() {
+  SettingsStore *store = SettingsStore::forProfile(m_dir->path());
+  QCOMPARE(store->fileName(), fileName());
+  QCOMPARE(SettingsStore::forProfile(m_dir->path() + "/"), store);
+
+  QTemporaryDir other;
+  QVERIFY(SettingsStore::forProfile(other.path()) != store);
+
+  store->setValue("Behavior/hideOnClose", false);
+  QVERIFY(store->flush(5000));
+  delete store;
+  QVERIFY(SettingsStore::forProfile(m_dir->path()) != nullptr);
+}
+
+void TestSettingsStore::testJournal() {
+  auto store = std::make_unique<SettingsStore>(fileName(), 60000);
+  store->setValue("Behavior/hideOnClose", false);
+  store->setValue("Permissions/granted/a/1", QString());
+  store->remove("Permissions/granted/a/1");
+  QVERIFY(!QFile::exists(fileName()));
+
+  // What a killed process leaves behind
+  QFile::copy(fileName() + ".journal", m_dir->filePath("journal"));
+  store.reset();
+  QFile::remove(fileName());
+  QVERIFY(!QFile::exists(fileName() + ".journal"));
+  QFile::copy(m_dir->filePath("journal"), fileName() + ".journal");
+
+  SettingsStore recovered(fileName(), 60000);
+  QCOMPARE(recovered.journalReplayed(), 3);
+  QCOMPARE(recovered.value("Behavior/hideOnClose", true).toBool(), false);
+  QVERIFY(!recovered.contains("Permissions/granted/a/1"));
+
+  // Compacted into the file, and the journal starts over
+  QVERIFY(recovered.flush(5000));
+  QCOMPARE(QFile(fileName() + ".journal").size(), 0);
+  QVERIFY(!QFile::exists(fileName() + ".journal.old"));
+  QSettings settings(fileName(), QSettings::IniFormat);
+  QCOMPARE(settings.value("Behavior/hideOnClose", true).toBool(), false);
+}
+
+void TestSettingsStore::testTornJournal() {
+  const QString journalName = fileName() + ".journal";
+  {
+    auto store = std::make_unique<SettingsStore>(fileName(), 60000);
+    store->setValue("a", 1);
+    store->setValue("b", 2);
+    store->setValue("c", QByteArray(100, 'c'));
+    QFile::copy(journalName, m_dir->filePath("journal"));
+  }
+  QFile::remove(fileName());
+  QFile::remove(journalName);
+
+  QFile journal(m_dir->filePath("journal"));
+  QVERIFY(journal.open(QIODevice::ReadOnly));
+  const QByteArray records = journal.readAll();
+  QFile torn(journalName);
+  QVERIFY(torn.open(QIODevice::WriteOnly));
+  torn.write(records.left(records.size() - 10));
+  torn.close();
+
+  {
+    SettingsStore store(fileName(), 60000);
+    QCOMPARE(store.journalReplayed(), 2);
+    QCOMPARE(store.value("a").toInt(), 1);
+    QCOMPARE(store.value("b").toInt(), 2);
+    QVERIFY(!store.contains("c"));
+
+    // Later changes are not lost behind the torn record
+    QVERIFY(QFile(journalName).size() < records.size() - 10);
+    store.setValue("d", 4);
+    QFile::copy(journalName, m_dir->filePath("journal2"));
+  }
+  QFile::remove(fileName());
+  QFile::remove(journalName);
+  QFile::copy(m_dir->filePath("journal2"), journalName);
+
+  SettingsStore store(fileName(), 60000);
+  QCOMPARE(store.journalReplayed(), 3);
+  QCOMPARE(store.value("d").toInt(), 4);
+}
+
+void TestSettingsStore::testJournalLimit() {
+  SettingsStore store(fileName(), 60000);
+  for (int i = 0; i < 100; ++i) {
+    store.setValue(QString("values/%1").arg(i), QByteArray(1024, 'v'));
+  }
+  QTRY_COMPARE_WITH_TIMEOUT(store.fileWrites(), 1, 5000);
+  QVERIFY(QFile(fileName() + ".journal").size() < 64 * 1024);
+
+  store.setValue("Behavior/hideOnClose", false);
+  QTest::qWait(200);
+  QCOMPARE(store.fileWrites(), 1);
+  QVERIFY(store.flush(5000));
+  QCOMPARE(store.fileWrites(), 2);
+}
+
+void TestSettingsStore::testCrashRecovery() {
+#ifndef Q_OS_UNIX
+  QSKIP("Needs SIGKILL");
+#else
+  QRandomGenerator random(20260816);
+  int lastCounter = 0;
+
+  for (int round = 0; round < 20; ++round) {
+    QProcess writer;
+    writer.start(QCoreApplication::applicationFilePath(),
+                 {"--write-until-killed", fileName()});
+    QVERIFY(writer.waitForStarted());
+    QVERIFY(writer.waitForReadyRead(5000));
+    QTest::qWait(random.bounded(1, 100));
+    ::kill(writer.processId(), SIGKILL);
+    QVERIFY(writer.waitForFinished(5000));
+    QCOMPARE(writer.exitStatus(), QProcess::CrashExit);
+
+    // The last line may have been cut short
+    const QList<QByteArray> lines =
+        writer.readAllStandardOutput().split('\n');
+    QVERIFY(lines.size() >= 2);
+    const int acknowledged = lines[lines.size() - 2].toInt();
+    QVERIFY(acknowledged > lastCounter);
+
+    SettingsStore store(fileName(), 60000);
+    const int counter = store.value("counter").toInt();
+    QVERIFY2(counter >= acknowledged,
+             qPrintable(QString("%1 < %2").arg(counter).arg(acknowledged)));
+
+    // Every key holds the last change made to it
+    for (int i = std::max(1, counter - 49); i <= counter; ++i) {
+      QCOMPARE(store.value(QString("keys/%1").arg(i % 50)).toInt(), i);
+    }
+    lastCounter = counter;
+  }
+#endif
+}
+
+// Run by testCrashRecovery: makes changes as fast as it can, compacting
+// every few milliseconds, and prints the number of each change once it is
+// in the journal
+static int writeUntilKilled(int argc, char *argv[]) {
+  QCoreApplication application(argc, argv);
+  SettingsStore store(QString::fromLocal8Bit(argv[2]), 5);
+  int counter = store.value("counter", 0).toInt();
+
+  QTimer timer;
+  QObject::connect(&timer, &QTimer::timeout, [&store, &counter]() {
+    ++counter;
+    store.setValue(QString("keys/%1").arg(counter % 50), counter);
+    store.setValue("counter", counter);
+    std::printf("%d\n", counter);
+    std::fflush(stdout);
+  });
+  timer.start(0);
+  return application.exec();
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 3 && qstrcmp(argv[1], "--write-until-killed") == 0) {
+    return writeUntilKilled(argc, argv);
+  }
+
+  QCoreApplication application(argc, argv);
+  TestSettingsStore test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_settingsstore.moc"
@@ -0,0 +1,84 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+#include <QThread>
+#include <QUuid>
+
+#include <atomic>
+#include <memory>
+
+#include "../singleinstance.h"
+
+class TestSingleInstance : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+
+  // Test that only the first instance for a key becomes primary
+  void testSecondInstanceIsRejected();
+
+  // Test that a forwarded launch reaches the primary with its URL
+  void testForwardReachesPrimary();
+
+  // Test that forwarding fails quickly when nobody is listening
+  void testForwardWithoutPrimary();
+
+private:
+  // Unique per run, so leftovers from an earlier run can't interfere
+  static QString uniqueKey() { return QUuid::createUuid().toString(); }
+};
+
+void TestSingleInstance::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestSingleInstance::testSecondInstanceIsRejected() {
+  const QString key = uniqueKey();
+  SingleInstance primary(key);
+  QVERIFY(primary.listen());
+
+  SingleInstance secondary(key);
+  QVERIFY(!secondary.listen());
+
+  // A different profile is independent
+  SingleInstance other(uniqueKey());
+  QVERIFY(other.listen());
+}
+
+void TestSingleInstance::testForwardReachesPrimary() {
+  const QString key = uniqueKey();
+  SingleInstance primary(key);
+  QVERIFY(primary.listen());
+  QSignalSpy spy(&primary, &SingleInstance::activationRequested);
+
+  // forward() blocks until the primary answers, and the primary answers from
+  // this thread's event loop, so forward from another thread
+  std::atomic<bool> forwarded{false};
+  std::unique_ptr<QThread> thread(QThread::create([&]() {
+    SingleInstance secondary(key);
+    forwarded = secondary.forward(QUrl("https://example.com/inbox"), true);
+  }));
+  thread->start();
+
+  QTRY_COMPARE(spy.count(), 1);
+  QVERIFY(thread->wait(5000));
+  QVERIFY(forwarded);
+  QCOMPARE(spy.at(0).at(0).toUrl(), QUrl("https://example.com/inbox"));
+  QCOMPARE(spy.at(0).at(1).toBool(), true);
+}
+
+void TestSingleInstance::testForwardWithoutPrimary() {
+  SingleInstance secondary(uniqueKey());
+  QElapsedTimer timer;
+  timer.start();
+  QVERIFY(!secondary.forward(QUrl(), false, 1000));
+  QVERIFY(timer.elapsed() < 1000);
+}
+
+QTEST_GUILESS_MAIN(TestSingleInstance)
+#include "tst_singleinstance.moc"
@@ -0,0 +1,348 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef WEBAPPRUNNER_H
+#define WEBAPPRUNNER_H
+
+// Helpers for tests and benchmarks that run the real webappcontainer binary:
+// a local HTTP server for fixtures and a runner that starts the app headless
+// with its own home directory and reads its startup trace.
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Serves a directory over HTTP on a free port with python3's http.server
+class FixtureServer {
+public:
+  ~FixtureServer() { stop(); }
+
+  bool start(const QString &directory, int timeoutMs = 10000) {
+    // Port 0 lets the OS pick a free port, the script reports which
+    static const char script[] = R"(
+import functools, http.server, sys
+handler = functools.partial(http.server.SimpleHTTPRequestHandler,
+                            directory=sys.argv[1])
+handler.func.log_message = lambda *args: None
+httpd = http.server.ThreadingHTTPServer(('127.0.0.1', 0), handler)
+print(httpd.server_address[1], flush=True)
+httpd.serve_forever()
+)";
+    m_process.start("python3", {"-c", script, directory});
+    if (!m_process.waitForStarted(timeoutMs)) {
+      return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!m_process.canReadLine()) {
+      const int remaining = timeoutMs - int(timer.elapsed());
+      if (remaining <= 0 || !m_process.waitForReadyRead(remaining)) {
+        stop();
+        return false;
+      }
+    }
+    m_port = m_process.readLine().trimmed().toInt();
+    return m_port > 0;
+  }
+
+  void stop() {
+    if (m_process.state() != QProcess::NotRunning) {
+      m_process.kill();
+      m_process.waitForFinished(5000);
+    }
+  }
+
+  int port() const { return m_port; }
+
+  // host can be "localhost" or "127.0.0.1", which count as different sites
+  QString url(const QString &path, const QString &host = "127.0.0.1") const {
+    return QString("http://%1:%2/%3").arg(host).arg(m_port).arg(path);
+  }
+
+private:
+  QProcess m_process;
+  int m_port = 0;
+};
+
+// Runs webappcontainer under the offscreen platform with a throwaway home,
+// so it never touches the user's profiles, launchers or startup slots
+class WebAppRunner {
+public:
+  explicit WebAppRunner(const QString &program) : m_program(program) {}
+  ~WebAppRunner() { stop(); }
+
+  bool start(const QStringList &arguments) {
+    if (!prepareHome()) {
+      return false;
+    }
+    m_tracePath = m_home.path() + "/trace.json";
+    QFile::remove(m_tracePath);
+
+    m_process.setProcessEnvironment(environment());
+    m_process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    QStringList args = arguments;
+    args << "--no-launcher" << "--no-notify" << "--startup-trace"
+         << m_tracePath;
+    m_clock.start();
+    m_process.start(m_program, args);
+    return m_process.waitForStarted(10000);
+  }
+
+  // Launches the app once more in the same home and waits for that process
+  // to exit, as a launch handed to the running launcher does. The app that
+  // start() ran has to be a launcher (--launcher) for this to time anything.
+  // Returns the monotonic time in milliseconds the launch started at, or -1
+  // if it didn't exit in time.
+  qint64 launch(const QStringList &arguments, int timeoutMs = 10000) {
+    QProcess process;
+    process.setProcessEnvironment(environment());
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    QElapsedTimer clock;
+    clock.start();
+    process.start(m_program, arguments + QStringList{"--no-notify"});
+    if (!process.waitForFinished(timeoutMs) ||
+        process.exitStatus() != QProcess::NormalExit ||
+        process.exitCode() != 0) {
+      process.kill();
+      process.waitForFinished(5000);
+      return -1;
+    }
+    return clock.msecsSinceReference();
+  }
+
+  // Waits until the trace contains event, or the app exits. With a profile,
+  // only an event recorded for that profile counts.
+  bool waitForEvent(const QString &event, int timeoutMs,
+                    const QString &profile = QString()) {
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < timeoutMs) {
+      if (eventTime(event, profile) >= 0) {
+        return true;
+      }
+      if (m_process.state() == QProcess::NotRunning) {
+        return false;
+      }
+      m_process.waitForFinished(50);
+    }
+    return false;
+  }
+
+  // Microseconds from StartupTrace::init() to the event, or -1
+  qint64 eventTime(const QString &name,
+                   const QString &profile = QString()) const {
+    const QJsonObject event = findEvent(name, profile);
+    return event.isEmpty() ? -1 : event["ts"].toInteger();
+  }
+
+  // The monotonic time in milliseconds the event was recorded at, or -1.
+  // Comparable with the times launch() returns.
+  qint64 eventMonotonicMs(const QString &name,
+                          const QString &profile = QString()) const {
+    const QJsonObject start = findEvent("processStart");
+    const qint64 time = eventTime(name, profile);
+    if (start.isEmpty() || time < 0) {
+      return -1;
+    }
+    return start["args"]["monotonicMs"].toInteger() + time / 1000;
+  }
+
+  // The arguments the event was recorded with
+  QJsonObject eventArgs(const QString &name,
+                        const QString &profile = QString()) const {
+    return findEvent(name, profile)["args"].toObject();
+  }
+
+  // Whether the first page that finished loading is url, rather than an
+  // error page or the default start page. The fragment is ignored, pages
+  // may route with it.
+  bool loaded(const QString &url, const QString &profile = QString()) const {
+    const QJsonObject args = eventArgs("firstLoadFinished", profile);
+    return args["ok"].toBool() &&
+           QUrl(args["url"].toString()).adjusted(QUrl::RemoveFragment) ==
+               QUrl(url).adjusted(QUrl::RemoveFragment);
+  }
+
+  // Microseconds between starting the process and StartupTrace::init(), the
+  // time spent exec'ing, loading libraries and running static constructors
+  qint64 launchOffset() const {
+    const QJsonObject event = findEvent("processStart");
+    if (event.isEmpty()) {
+      return -1;
+    }
+    const qint64 started = event["args"]["monotonicMs"].toInteger();
+    return (started - m_clock.msecsSinceReference()) * 1000;
+  }
+
+  // Drops the app's files from the page cache, as after a reboot, without
+  // needing root. Dirty pages are written out first, the kernel won't drop
+  // them otherwise. Libraries stay cached, only profile reads go cold.
+  void evictFromPageCache() const {
+#ifdef Q_OS_LINUX
+    QDirIterator it(m_home.path(), QDir::Files | QDir::Hidden,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+      const QByteArray path = QFile::encodeName(it.next());
+      const int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        continue;
+      }
+      ::fdatasync(fd);
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      ::close(fd);
+    }
+#endif
+  }
+
+  // HOME of the app, with the XDG directories below it
+  QString homePath() const { return m_home.path(); }
+
+  qint64 elapsedMs() const { return m_clock.elapsed(); }
+  qint64 pid() const { return m_process.processId(); }
+
+  // Summed over the app and every process it started. The peak is the sum
+  // of each process' own peak, an upper bound for the peak of the whole.
+  qint64 residentKb() const { return sumStatus("VmRSS:"); }
+  qint64 peakResidentKb() const { return sumStatus("VmHWM:"); }
+  int processCount() const { return processTree().size(); }
+
+  void stop() {
+    if (m_process.state() == QProcess::NotRunning) {
+      return;
+    }
+    m_process.terminate();
+    if (!m_process.waitForFinished(5000)) {
+      m_process.kill();
+      m_process.waitForFinished(5000);
+    }
+  }
+
+private:
+  bool prepareHome() const {
+    if (!m_home.isValid()) {
+      return false;
+    }
+    const QString runtime = m_home.path() + "/runtime";
+    QDir().mkpath(runtime);
+    return QFile::setPermissions(runtime, QFileDevice::ReadOwner |
+                                              QFileDevice::WriteOwner |
+                                              QFileDevice::ExeOwner);
+  }
+
+  QProcessEnvironment environment() const {
+    const QString home = m_home.path();
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("HOME", home);
+    env.insert("XDG_CONFIG_HOME", home + "/config");
+    env.insert("XDG_DATA_HOME", home + "/data");
+    env.insert("XDG_CACHE_HOME", home + "/cache");
+    env.insert("XDG_RUNTIME_DIR", home + "/runtime");
+    env.insert("QT_QPA_PLATFORM", "offscreen");
+    // No GPU on build machines, and the sandbox needs setup CI doesn't have
+    env.insert("QTWEBENGINE_CHROMIUM_FLAGS", "--disable-gpu");
+    env.insert("QTWEBENGINE_DISABLE_SANDBOX", "1");
+    return env;
+  }
+
+  // The trace is rewritten as a whole, so a read never sees half a file. A
+  // launcher records events for every app it opens, tagged with the profile.
+  QJsonObject findEvent(const QString &name,
+                        const QString &profile = QString()) const {
+    QFile file(m_tracePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return QJsonObject();
+    }
+    const QJsonArray events =
+        QJsonDocument::fromJson(file.readAll())["traceEvents"].toArray();
+    for (const QJsonValue &value : events) {
+      if (value["name"].toString() == name &&
+          (profile.isEmpty() ||
+           value["args"]["profile"].toString() == profile)) {
+        return value.toObject();
+      }
+    }
+    return QJsonObject();
+  }
+
+  QList<qint64> processTree() const {
+    QList<qint64> tree;
+    if (m_process.state() == QProcess::NotRunning) {
+      return tree;
+    }
+    tree.append(m_process.processId());
+
+    // Map every process to its parent, then collect descendants
+    QHash<qint64, qint64> parents;
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs);
+    for (const QString &entry : entries) {
+      bool ok = false;
+      const qint64 pid = entry.toLongLong(&ok);
+      if (!ok) {
+        continue;
+      }
+      QFile stat("/proc/" + entry + "/stat");
+      if (!stat.open(QIODevice::ReadOnly)) {
+        continue;
+      }
+      // The command name may contain spaces, the fields after it don't
+      const QByteArray line = stat.readAll();
+      const QList<QByteArray> fields =
+          line.mid(line.lastIndexOf(')') + 2).split(' ');
+      if (fields.size() > 1) {
+        parents.insert(pid, fields[1].toLongLong());
+      }
+    }
+
+    for (qsizetype i = 0; i < tree.size(); ++i) {
+      for (auto it = parents.cbegin(); it != parents.cend(); ++it) {
+        if (it.value() == tree[i]) {
+          tree.append(it.key());
+        }
+      }
+    }
+    return tree;
+  }
+
+  qint64 sumStatus(const QByteArray &key) const {
+    qint64 total = 0;
+    const QList<qint64> tree = processTree();
+    for (qint64 pid : tree) {
+      QFile status(QString("/proc/%1/status").arg(pid));
+      if (!status.open(QIODevice::ReadOnly)) {
+        continue;
+      }
+      while (!status.atEnd()) {
+        const QByteArray line = status.readLine();
+        if (line.startsWith(key)) {
+          total += line.mid(key.size()).simplified().split(' ')[0].toLongLong();
+          break;
+        }
+      }
+    }
+    return total;
+  }
+
+  QString m_program;
+  QTemporaryDir m_home;
+  QString m_tracePath;
+  QProcess m_process;
+  QElapsedTimer m_clock;
+};
+
+#endif // WEBAPPRUNNER_H
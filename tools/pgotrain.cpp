@@ -0,0 +1,156 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+// Training workload for profile-guided builds. Runs an instrumented
+// webappcontainer headless against the fixtures in tests/resources and quits
+// it cleanly after each scenario, so the profile counters are written out.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QProcess>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUrl>
+
+#include <cstdio>
+#include <memory>
+
+#include "../tests/webapprunner.h"
+
+struct Scenario {
+  const char *name;
+  const char *page;
+  int settleMs; // how long the page keeps working after it has loaded
+  int runs;
+  bool freshProfile;
+};
+
+// What users spend most of their time in: starting apps, opening links,
+// receiving notifications and saving files
+static const Scenario scenarios[] = {
+    {"startup", "spa/index.html", 500, 5, true},
+    {"restart", "spa/index.html", 500, 5, false},
+    {"popups", "pgo/popups.html", 5000, 2, true},
+    {"notifications", "pgo/notifications.html", 4000, 2, true},
+    {"downloads", "pgo/downloads.html", 2000, 2, true},
+};
+
+// Pre-grants notifications to the fixture origin, headless runs can't answer
+// the permission prompt. The record is the one PermissionStore::recordKey()
+// writes, a grant without an expiry that is handed to Chromium on startup.
+static void grantNotifications(const WebAppRunner &runner,
+                               const FixtureServer &server) {
+  QSettings settings(runner.homePath() +
+                         "/data/JosephCrowell/Web App Container/QtWebEngine/"
+                         "pgo/settings.ini",
+                     QSettings::IniFormat);
+  // The origin FixtureServer::url() serves the pages from
+  const QString origin = QString("http://127.0.0.1:%1").arg(server.port());
+  // QWebEnginePermission::PermissionType::Notifications
+  settings.setValue("Permissions/granted/" +
+                        QString::fromLatin1(QUrl::toPercentEncoding(origin)) +
+                        "/7",
+                    QString());
+  settings.sync();
+}
+
+// Cross-site popups go to the default browser, which must not start here
+static QString stubBrowser(const QTemporaryDir &directory) {
+  const QString path = directory.filePath("xdg-open");
+  QFile stub(path);
+  if (stub.open(QIODevice::WriteOnly)) {
+    stub.write("#!/bin/sh\nexit 0\n");
+    stub.close();
+    stub.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                        QFileDevice::ExeOwner);
+  }
+  return directory.path();
+}
+
+// Clang writes raw profiles that have to be merged before they can be used
+static bool mergeClangProfiles(const QString &llvmProfdata,
+                               const QString &profileDir) {
+  const QStringList raw =
+      QDir(profileDir).entryList({"*.profraw"}, QDir::Files);
+  if (raw.isEmpty()) {
+    std::fprintf(stderr, "pgotrain: no raw profiles in %s\n",
+                 qPrintable(profileDir));
+    return false;
+  }
+
+  QStringList arguments{"merge", "-o", "webappcontainer.profdata"};
+  arguments += raw;
+  QProcess merge;
+  merge.setWorkingDirectory(profileDir);
+  merge.setProcessChannelMode(QProcess::ForwardedChannels);
+  merge.start(llvmProfdata, arguments);
+  return merge.waitForFinished(-1) &&
+         merge.exitStatus() == QProcess::NormalExit && merge.exitCode() == 0;
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication application(argc, argv);
+  const QStringList arguments = application.arguments();
+  if (arguments.size() != 4 && arguments.size() != 5) {
+    std::fprintf(stderr,
+                 "Usage: %s <webappcontainer> <tests/resources> <profile dir> "
+                 "[llvm-profdata]\n",
+                 argv[0]);
+    return 1;
+  }
+  const QString program = arguments[1];
+  const QString fixtures = arguments[2];
+  const QString profileDir = arguments[3];
+
+  FixtureServer server;
+  if (!server.start(fixtures)) {
+    std::fprintf(stderr, "pgotrain: python3 is needed to serve %s\n",
+                 qPrintable(fixtures));
+    return 1;
+  }
+
+  QTemporaryDir bin;
+  qputenv("PATH", stubBrowser(bin).toLocal8Bit() + ":" + qgetenv("PATH"));
+
+  int completed = 0;
+  for (const Scenario &scenario : scenarios) {
+    std::unique_ptr<WebAppRunner> runner;
+    for (int i = 0; i < scenario.runs; ++i) {
+      if (!runner || scenario.freshProfile) {
+        runner = std::make_unique<WebAppRunner>(program);
+        grantNotifications(*runner, server);
+      }
+      std::printf("pgotrain: %s %d/%d\n", scenario.name, i + 1,
+                  scenario.runs);
+      std::fflush(stdout);
+
+      const QString url = server.url(scenario.page);
+      if (!runner->start({"--profile", "pgo", "--url", url}) ||
+          !runner->waitForEvent("firstLoadFinished", 60000) ||
+          !runner->loaded(url)) {
+        std::fprintf(stderr, "pgotrain: %s did not load\n", scenario.name);
+        runner->stop();
+        continue;
+      }
+      QThread::msleep(scenario.settleMs);
+
+      // SIGTERM, so the instrumented binary exits normally and writes its
+      // counters
+      runner->stop();
+      ++completed;
+    }
+  }
+
+  if (completed == 0) {
+    std::fprintf(stderr, "pgotrain: no scenario ran, no profile written\n");
+    return 1;
+  }
+  const QString llvmProfdata = arguments.value(4);
+  if (!llvmProfdata.isEmpty() &&
+      !mergeClangProfiles(llvmProfdata, profileDir)) {
+    return 1;
+  }
+  std::printf("pgotrain: profile written to %s\n", qPrintable(profileDir));
+  return 0;
+}
@@ -0,0 +1,234 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+// Build-time tool that compiles public_suffix_list.dat into a constexpr label
+// trie, so the application doesn't have to parse the text list on startup.
+// With --snapshot it writes the binary snapshot that running instances map
+// and hot reload instead.
+//
+// Usage: pslcompiler <public_suffix_list.dat> <publicsuffixlist_data.h>
+//        pslcompiler --snapshot <public_suffix_list.dat> <snapshot.bin>
+
+#include "../publicsuffixtable.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Decodes UTF-8 into UTF-16, lowercasing ASCII on the way. The list itself is
+// already lowercase; this only guards against stray uppercase ASCII rules.
+static bool decodeRule(std::string_view in, std::u16string &out) {
+  out.clear();
+  for (std::size_t i = 0; i < in.size();) {
+    unsigned char c = static_cast<unsigned char>(in[i]);
+    char32_t cp;
+    std::size_t length;
+    if (c < 0x80) {
+      cp = c;
+      length = 1;
+    } else if ((c & 0xE0) == 0xC0) {
+      cp = c & 0x1F;
+      length = 2;
+    } else if ((c & 0xF0) == 0xE0) {
+      cp = c & 0x0F;
+      length = 3;
+    } else if ((c & 0xF8) == 0xF0) {
+      cp = c & 0x07;
+      length = 4;
+    } else {
+      return false;
+    }
+    if (i + length > in.size()) {
+      return false;
+    }
+    for (std::size_t j = 1; j < length; ++j) {
+      unsigned char next = static_cast<unsigned char>(in[i + j]);
+      if ((next & 0xC0) != 0x80) {
+        return false;
+      }
+      cp = (cp << 6) | (next & 0x3F);
+    }
+    i += length;
+
+    if (cp >= 'A' && cp <= 'Z') {
+      cp += 'a' - 'A';
+    }
+    if (cp > 0xFFFF) {
+      cp -= 0x10000;
+      out.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+      out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+    } else {
+      out.push_back(static_cast<char16_t>(cp));
+    }
+  }
+  return true;
+}
+
+// Writes the label pool as a u"" literal, escaping everything but printable
+// ASCII. Surrogate pairs are re-joined into a single \U escape.
+static void writeLabels(std::ostream &out, const std::u16string &labels) {
+  constexpr std::size_t lineLength = 72;
+  std::size_t column = 0;
+  out << "    u\"";
+  for (std::size_t i = 0; i < labels.size(); ++i) {
+    char16_t c = labels[i];
+    char escape[16];
+    if (c >= 0xD800 && c < 0xDC00 && i + 1 < labels.size()) {
+      char32_t cp = 0x10000 + ((char32_t(c) - 0xD800) << 10) +
+                    (char32_t(labels[++i]) - 0xDC00);
+      std::snprintf(escape, sizeof(escape), "\\U%08X", unsigned(cp));
+    } else if (c < 0x20 || c == 0x7F || c == '"' || c == '\\' || c == '?') {
+      std::snprintf(escape, sizeof(escape), "\\%03o", unsigned(c));
+    } else if (c > 0x7F) {
+      std::snprintf(escape, sizeof(escape), "\\u%04X", unsigned(c));
+    } else {
+      escape[0] = static_cast<char>(c);
+      escape[1] = '\0';
+    }
+    out << escape;
+    column += std::char_traits<char>::length(escape);
+    if (column >= lineLength && i + 1 < labels.size()) {
+      out << "\"\n    u\"";
+      column = 0;
+    }
+  }
+  out << "\"";
+}
+
+// Writes the snapshot next to its destination and renames it into place, so
+// instances watching the file never map a half written snapshot
+static bool writeSnapshot(const psl::Table &table,
+                          const std::string &listVersion, const char *path) {
+  const std::filesystem::path destination(path);
+  std::error_code error;
+  if (destination.has_parent_path()) {
+    std::filesystem::create_directories(destination.parent_path(), error);
+  }
+
+  std::filesystem::path temporary = destination;
+  temporary += ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file << psl::writeSnapshot(table, listVersion);
+    if (!file) {
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporary, destination, error);
+  return !error;
+}
+
+int main(int argc, char *argv[]) {
+  const bool snapshot = argc == 4 && std::string_view(argv[1]) == "--snapshot";
+  if (argc != 3 && !snapshot) {
+    std::cerr << "Usage: " << argv[0]
+              << " <public_suffix_list.dat> <publicsuffixlist_data.h>\n"
+              << "       " << argv[0]
+              << " --snapshot <public_suffix_list.dat> <snapshot.bin>\n";
+    return 1;
+  }
+  const char *inputPath = argv[snapshot ? 2 : 1];
+  const char *outputPath = argv[snapshot ? 3 : 2];
+
+  std::ifstream in(inputPath);
+  if (!in) {
+    std::cerr << "pslcompiler: could not open " << inputPath << "\n";
+    return 1;
+  }
+
+  psl::TableBuilder builder;
+  std::size_t ruleCount = 0;
+  std::string line;
+  std::string listVersion;
+  std::u16string rule;
+  while (std::getline(in, line)) {
+    // A rule ends at the first whitespace
+    std::size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+      continue;
+    }
+    std::size_t end = line.find_first_of(" \t\r", start);
+    std::string_view text =
+        std::string_view(line).substr(start, end == std::string::npos
+                                                 ? std::string::npos
+                                                 : end - start);
+
+    // Skip comments, but remember which version of the list this is
+    if (text.starts_with("//")) {
+      constexpr std::string_view versionTag = "// VERSION: ";
+      if (listVersion.empty() && line.starts_with(versionTag)) {
+        listVersion = line.substr(versionTag.size());
+        listVersion.erase(listVersion.find_last_not_of(" \t\r") + 1);
+      }
+      continue;
+    }
+
+    if (!decodeRule(text, rule)) {
+      std::cerr << "pslcompiler: skipping invalid UTF-8 rule: " << text
+                << "\n";
+      continue;
+    }
+    builder.addRule(rule);
+    ++ruleCount;
+  }
+
+  psl::Table table = builder.build();
+
+  if (snapshot) {
+    if (!writeSnapshot(table, listVersion, outputPath)) {
+      std::cerr << "pslcompiler: could not write " << outputPath << "\n";
+      return 1;
+    }
+    std::cout << "pslcompiler: wrote snapshot of list " << listVersion
+              << " to " << outputPath << "\n";
+    return 0;
+  }
+
+  std::ostringstream out;
+  out << "// Generated by pslcompiler from public_suffix_list.dat. Do not edit.\n"
+         "\n"
+         "#ifndef PUBLICSUFFIXLIST_DATA_H\n"
+         "#define PUBLICSUFFIXLIST_DATA_H\n"
+         "\n"
+         "#include \"publicsuffixtable.h\"\n"
+         "\n"
+         "namespace psl::generated {\n"
+         "\n"
+         "inline constexpr char listVersion[] = \""
+      << listVersion
+      << "\";\n"
+         "inline constexpr std::uint32_t ruleCount = "
+      << ruleCount
+      << ";\n"
+         "\n"
+         "inline constexpr char16_t labels[] =\n";
+  writeLabels(out, builder.labels());
+  out << ";\n"
+         "\n"
+         "inline constexpr Node nodes[] = {\n";
+  for (const psl::Node &node : builder.nodes()) {
+    out << "    {" << node.labelOffset << ", " << node.firstChild << ", "
+        << node.childCount << ", " << unsigned(node.labelLength) << ", "
+        << unsigned(node.flags) << "},\n";
+  }
+  out << "};\n"
+         "\n"
+         "} // namespace psl::generated\n"
+         "\n"
+         "#endif // PUBLICSUFFIXLIST_DATA_H\n";
+
+  std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+  file << out.str();
+  if (!file) {
+    std::cerr << "pslcompiler: could not write " << outputPath << "\n";
+    return 1;
+  }
+
+  std::cout << "pslcompiler: " << ruleCount << " rules, " << table.nodeCount
+            << " nodes, " << table.labelsSize << " label characters\n";
+  return 0;
+}
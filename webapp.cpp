@@ -0,0 +1,293 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#include "webapp.h"
+
+#include "browserwindow.h"
+#include "memoryprofile.h"
+#include "permissionstore.h"
+#include "preconnect.h"
+#include "readahead.h"
+#include "startuptrace.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QTimer>
+#include <QWebEngineProfile>
+#include <QWebEngineSettings>
+
+// The system counts as idle once this much CPU time was idle over a sample
+static constexpr double idleFraction = 0.8;
+static constexpr int idleSampleMs = 2000;
+// Load anyway if the system never settles
+static constexpr int maximumIdleWaitMs = 5 * 60 * 1000;
+
+// Reads the busy and idle time of all CPUs since boot from /proc/stat
+static bool readCpuTimes(quint64 &busy, quint64 &idle) {
+  QFile file("/proc/stat");
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  // cpu  user nice system idle iowait irq softirq steal ...
+  const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+  if (fields.size() < 5 || fields[0] != "cpu") {
+    return false;
+  }
+  busy = 0;
+  idle = 0;
+  for (qsizetype i = 1; i < fields.size() && i <= 8; ++i) {
+    // idle and iowait
+    if (i == 4 || i == 5) {
+      idle += fields[i].toULongLong();
+    } else {
+      busy += fields[i].toULongLong();
+    }
+  }
+  return true;
+}
+
+WebApp::WebApp(const AppConfig &config, QObject *parent)
+    : QObject(parent), m_config(config), m_instance(config.profilePath()) {
+  connect(&m_instance, &SingleInstance::activationRequested, this,
+          &WebApp::activate);
+}
+
+WebApp::~WebApp() {
+  // The pages have to go before the profile they belong to
+  delete m_window;
+  delete m_profile;
+}
+
+bool WebApp::claimProfile() { return m_instance.listen(); }
+
+bool WebApp::forwardToRunningInstance() {
+  return m_instance.forward(m_config.url, !m_config.startMinimized);
+}
+
+void WebApp::createProfile() {
+  QString name = m_config.profile();
+  QString profilePath = m_config.profilePath();
+  QDir().mkpath(profilePath);
+
+  // Create the profile and set paths
+  StartupTrace::begin("QWebEngineProfile");
+  QWebEngineProfile *profile = new QWebEngineProfile(name);
+  profile->setPersistentStoragePath(profilePath);
+  profile->setCachePath(profilePath + QDir::separator() + "cache");
+
+  // Set policies
+  profile->setPersistentPermissionsPolicy(
+      QWebEngineProfile::PersistentPermissionsPolicy::StoreOnDisk);
+  // Reconciles our grants with Chromium's, and revokes them when they expire
+  PermissionStore::forProfile(profile);
+  profile->setPersistentCookiesPolicy(
+      QWebEngineProfile::AllowPersistentCookies);
+
+  MemoryProfile::applyToProfile(MemoryProfile::active(), profile);
+
+  // Enable Web Push API for service worker push notifications
+  profile->setPushServiceEnabled(true);
+
+  // Set remaining profile settings
+  profile->settings()->setAttribute(QWebEngineSettings::JavascriptEnabled,
+                                    true);
+  profile->settings()->setAttribute(QWebEngineSettings::LocalStorageEnabled,
+                                    true);
+  profile->settings()->setAttribute(QWebEngineSettings::PluginsEnabled, true);
+  profile->settings()->setAttribute(QWebEngineSettings::DnsPrefetchEnabled,
+                                    true);
+  profile->settings()->setAttribute(
+      QWebEngineSettings::LocalContentCanAccessRemoteUrls, true);
+  profile->settings()->setAttribute(
+      QWebEngineSettings::LocalContentCanAccessFileUrls, false);
+  profile->settings()->setAttribute(QWebEngineSettings::ScreenCaptureEnabled,
+                                    true);
+  profile->setHttpUserAgent(
+      "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+      "Chrome/143.0.7499.169/170 Safari/537.36");
+
+  if (profile->isOffTheRecord()) {
+    qWarning() << "Warning: Profile is still Off-The-Record! This should not "
+                  "happen with a named profile.";
+  } else {
+    qDebug() << "Profile is On-The-Record (Persistent). Storage path:"
+             << profile->persistentStoragePath();
+  }
+  StartupTrace::end("QWebEngineProfile");
+
+  m_profile = profile;
+}
+
+void WebApp::start() {
+  if (m_window) {
+    return;
+  }
+  m_startTimer.start();
+
+  // Pull the profile's files into the page cache before Chromium opens them,
+  // and learn which ones to pull next time
+  m_readahead = new Readahead(m_config.profilePath(), this);
+  if (m_config.readahead) {
+    m_readahead->start();
+  }
+  m_readahead->record();
+
+  // Resolve the hosts the app used last time while the profile and window
+  // are being created
+  m_preconnect = new Preconnect(m_config.profilePath(), this);
+  m_preconnect->warmUp();
+
+  createProfile();
+  m_preconnect->attach(m_profile);
+
+  StartupTrace::begin("BrowserWindow");
+  m_window = new BrowserWindow(m_profile, m_config.appName, m_config.iconPath,
+                               m_config.trayIconPath, m_config.notify);
+  m_window->setNotificationLimit(m_config.notificationLimit);
+  StartupTrace::end("BrowserWindow");
+
+  // Once the page is up, whatever is left to read isn't worth the disk time,
+  // and later pages don't need the start page's preconnect hints
+  connect(m_window->webView(), &QWebEngineView::loadFinished, m_readahead,
+          &Readahead::cancel, Qt::SingleShotConnection);
+  connect(m_window->webView(), &QWebEngineView::loadFinished, m_preconnect,
+          &Preconnect::removeHints, Qt::SingleShotConnection);
+
+  connect(m_window, &BrowserWindow::quitRequested, this, [this]() {
+    // Lets the window save its layout before it goes away
+    m_window->close();
+    emit quitRequested();
+  });
+  // Set an initial URL
+  m_pendingUrl = m_config.url.isEmpty() ? QUrl("https://www.google.com")
+                                        : m_config.url;
+  const bool deferLoad =
+      m_config.startMinimized &&
+      m_config.minimizedLoad != AppConfig::LoadImmediately;
+  if (!deferLoad) {
+    loadStartUrl("start");
+  }
+
+  if (m_config.startMinimized) {
+    m_window->createTrayIcon();
+    m_window->show();
+    m_window->hide();
+  } else {
+    m_window->show();
+    StartupTrace::mark("windowShown", {{"profile", m_config.profile()}});
+  }
+
+  if (deferLoad) {
+    StartupTrace::mark("startUrlDeferred",
+                       {{"policy", AppConfig::minimizedLoadName(
+                                       m_config.minimizedLoad)}});
+    // Whatever the policy, an app the user opens loads right away
+    m_window->installEventFilter(this);
+
+    if (m_config.minimizedLoad == AppConfig::LoadWhenIdle) {
+      readCpuTimes(m_cpuBusy, m_cpuIdle);
+      m_idleTimer = new QTimer(this);
+      m_idleTimer->setInterval(idleSampleMs);
+      connect(m_idleTimer, &QTimer::timeout, this, &WebApp::checkIdle);
+      m_idleTimer->start();
+    }
+  }
+}
+
+void WebApp::activate(const QUrl &url, bool raise) {
+  // Launched again while this one waits for a startup slot, start with what
+  // the later launch asked for
+  if (!m_window) {
+    if (url.isValid()) {
+      m_config.url = url;
+    }
+    if (raise) {
+      m_config.startMinimized = false;
+    }
+    return;
+  }
+
+  if (m_pendingUrl.isEmpty()) {
+    m_window->activate(url, raise);
+    return;
+  }
+
+  // A forwarded URL replaces the queued start URL. Raising the window loads
+  // it through the event filter.
+  if (url.isValid()) {
+    m_pendingUrl = url;
+    loadStartUrl("activate");
+  }
+  m_window->activate(QUrl(), raise);
+}
+
+void WebApp::loadStartUrl(const char *reason) {
+  if (m_pendingUrl.isEmpty()) {
+    return;
+  }
+
+  const QString policy =
+      m_config.startMinimized
+          ? AppConfig::minimizedLoadName(m_config.minimizedLoad)
+          : QStringLiteral("foreground");
+  const qint64 queuedMs = m_startTimer.elapsed();
+  StartupTrace::mark("startUrlLoad", {{"policy", policy},
+                                      {"reason", QString::fromLatin1(reason)},
+                                      {"queuedMs", queuedMs}});
+
+  // Start to interactive, per policy, so the policies can be compared. Also
+  // logged in release builds, where qDebug is compiled out.
+  connect(
+      m_window->webView(), &QWebEngineView::loadFinished, this,
+      [this, policy, queuedMs](bool ok) {
+        const qint64 interactiveMs = m_startTimer.elapsed();
+        StartupTrace::mark("startUrlInteractive",
+                           {{"policy", policy},
+                            {"ok", ok},
+                            {"queuedMs", queuedMs},
+                            {"interactiveMs", interactiveMs}});
+        qInfo() << "Start URL loaded (" << policy << ") ok:" << ok
+                << "queued" << queuedMs << "ms, interactive after"
+                << interactiveMs << "ms";
+      },
+      Qt::SingleShotConnection);
+
+  m_window->webView()->setUrl(m_pendingUrl);
+  m_pendingUrl.clear();
+
+  if (m_idleTimer) {
+    m_idleTimer->stop();
+  }
+  m_window->removeEventFilter(this);
+}
+
+void WebApp::checkIdle() {
+  quint64 busy = 0;
+  quint64 idle = 0;
+  if (!readCpuTimes(busy, idle)) {
+    loadStartUrl("no cpu statistics");
+    return;
+  }
+
+  const quint64 busyDelta = busy - m_cpuBusy;
+  const quint64 idleDelta = idle - m_cpuIdle;
+  m_cpuBusy = busy;
+  m_cpuIdle = idle;
+
+  const quint64 total = busyDelta + idleDelta;
+  if (total > 0 && double(idleDelta) / double(total) >= idleFraction) {
+    loadStartUrl("idle");
+  } else if (m_startTimer.elapsed() >= maximumIdleWaitMs) {
+    loadStartUrl("idle timeout");
+  }
+}
+
+bool WebApp::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_window && event->type() == QEvent::Show) {
+    loadStartUrl("restore");
+  }
+  return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,77 @@
+// Copyright(C) 2026 Joseph Crowell.
+// SPDX - License - Identifier : GPL-2.0-or-later
+
+#ifndef WEBAPP_H
+#define WEBAPP_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QUrl>
+
+#include "appconfig.h"
+#include "singleinstance.h"
+
+class BrowserWindow;
+class Preconnect;
+class Readahead;
+class QTimer;
+class QWebEngineProfile;
+
+// One web app: its persistent profile, its window and the claim on its
+// profile that keeps other processes from opening the same storage.
+class WebApp : public QObject {
+  Q_OBJECT
+
+public:
+  explicit WebApp(const AppConfig &config, QObject *parent = nullptr);
+  ~WebApp();
+
+  // Claims the profile for this process. Returns false if another process is
+  // already running it.
+  bool claimProfile();
+
+  // Hands this launch to the process that runs the profile
+  bool forwardToRunningInstance();
+
+  // Creates the profile and the window and starts loading the app
+  void start();
+
+  // Handles a launch forwarded from another process, also one that arrives
+  // before start()
+  void activate(const QUrl &url, bool raise);
+
+  // Whether start() left the start URL for the --minimized-load policy to
+  // load later
+  bool isStartUrlDeferred() const { return !m_pendingUrl.isEmpty(); }
+
+  const AppConfig &config() const { return m_config; }
+  BrowserWindow *window() const { return m_window; }
+
+signals:
+  // The user chose to exit this app
+  void quitRequested();
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  void createProfile();
+  void loadStartUrl(const char *reason);
+  void checkIdle();
+
+  AppConfig m_config;
+  SingleInstance m_instance;
+  QWebEngineProfile *m_profile = nullptr;
+  BrowserWindow *m_window = nullptr;
+  Preconnect *m_preconnect = nullptr;
+  Readahead *m_readahead = nullptr;
+
+  // Start URL of a --minimized app that is waiting for its load policy
+  QUrl m_pendingUrl;
+  QElapsedTimer m_startTimer;
+  QTimer *m_idleTimer = nullptr;
+  quint64 m_cpuBusy = 0;
+  quint64 m_cpuIdle = 0;
+};
+
+#endif // WEBAPP_H
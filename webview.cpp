@@ -4,6 +4,9 @@
 #include "webview.h"
 #include "ui_certificateerrordialog.h"
 #include "ui_passworddialog.h"
+#include "permissionstore.h"
+#include "promptqueue.h"
+#include "settingsstore.h"
 #include "webauthdialog.h"
 #include "webpage.h"
 #include <QAuthenticator>
@@ -11,17 +14,17 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QMenu>
-#include <QMessageBox>
-#include <QSettings>
 #include <QStyle>
 #include <QTimer>
 #include <QWebEngineContextMenuRequest>
 #include <QWebEngineProfile>
 
+#include <memory>
+
 using namespace Qt::StringLiterals;
 
 WebView::WebView(QWebEngineProfile *profile, QWidget *parent)
-    : QWebEngineView(parent) {
+    : QWebEngineView(parent), m_prompts(new PromptQueue(this)) {
   WebPage *page = new WebPage(profile, this);
   setPage(page);
 
@@ -56,13 +59,15 @@ WebView::WebView(QWebEngineProfile *profile, QWidget *parent)
               status = tr("Render process killed");
               break;
             }
-            QMessageBox::StandardButton btn =
-                QMessageBox::question(window(), status,
-                                      tr("Render process exited with code: %1\n"
-                                         "Do you want to reload the page ?")
-                                          .arg(statusCode));
-            if (btn == QMessageBox::Yes)
-              QTimer::singleShot(0, this, &WebView::reload);
+            m_prompts->question(
+                "renderProcessTerminated", status,
+                tr("Render process exited with code: %1\n"
+                   "Do you want to reload the page ?")
+                    .arg(statusCode),
+                [this](bool reload) {
+                  if (reload)
+                    QTimer::singleShot(0, this, &WebView::reload);
+                });
           });
 }
 
@@ -224,46 +229,81 @@ void WebView::contextMenuEvent(QContextMenuEvent *event) {
 }
 
 void WebView::handleCertificateError(QWebEngineCertificateError error) {
-  QDialog dialog(window());
-  dialog.setModal(true);
-  dialog.setWindowFlags(dialog.windowFlags() &
-                        ~Qt::WindowContextHelpButtonHint);
+  // The error is deferred, it waits for the answer
+  const QString key =
+      QString("certificate\n%1\n%2")
+          .arg(PermissionStore::originKey(error.url()),
+               QString::number(static_cast<int>(error.type())));
+  m_prompts->ask(
+      key,
+      [error](QWidget *parent) {
+        QDialog *dialog = new QDialog(parent);
+        Ui::CertificateErrorDialog certificateDialog;
+        certificateDialog.setupUi(dialog);
+        certificateDialog.m_iconLabel->setText(QString());
+        QIcon icon(parent->style()->standardIcon(QStyle::SP_MessageBoxWarning,
+                                                 0, parent));
+        certificateDialog.m_iconLabel->setPixmap(icon.pixmap(32, 32));
+        certificateDialog.m_errorLabel->setText(error.description());
+        dialog->setWindowTitle(tr("Certificate Error"));
+        return dialog;
+      },
+      [error](bool accepted) mutable {
+        if (accepted)
+          error.acceptCertificate();
+        else
+          error.rejectCertificate();
+      });
+}
+
+static void setUpPasswordDialog(QDialog *dialog,
+                                Ui::PasswordDialog &passwordDialog,
+                                const QString &introMessage) {
+  passwordDialog.setupUi(dialog);
+  passwordDialog.m_iconLabel->setText(QString());
+  QIcon icon(dialog->style()->standardIcon(QStyle::SP_MessageBoxQuestion, 0,
+                                           dialog));
+  passwordDialog.m_iconLabel->setPixmap(icon.pixmap(32, 32));
+  passwordDialog.m_infoLabel->setText(introMessage);
+  passwordDialog.m_infoLabel->setWordWrap(true);
+}
+
+void WebView::askForCredentials(const QString &key,
+                                const QString &introMessage) {
+  // A prompt for the same realm is already open
+  if (m_prompts->contains(key)) {
+    return;
+  }
 
-  Ui::CertificateErrorDialog certificateDialog;
-  certificateDialog.setupUi(&dialog);
-  certificateDialog.m_iconLabel->setText(QString());
-  QIcon icon(window()->style()->standardIcon(QStyle::SP_MessageBoxWarning, 0,
-                                             window()));
-  certificateDialog.m_iconLabel->setPixmap(icon.pixmap(32, 32));
-  certificateDialog.m_errorLabel->setText(error.description());
-  dialog.setWindowTitle(tr("Certificate Error"));
-
-  if (dialog.exec() == QDialog::Accepted)
-    error.acceptCertificate();
-  else
-    error.rejectCertificate();
+  m_prompts->ask(
+      key,
+      [this, key, introMessage](QWidget *parent) {
+        QDialog *dialog = new QDialog(parent);
+        auto passwordDialog = std::make_shared<Ui::PasswordDialog>();
+        setUpPasswordDialog(dialog, *passwordDialog, introMessage);
+
+        connect(dialog, &QDialog::accepted, this,
+                [this, key, passwordDialog]() {
+                  m_credentials.insert(
+                      key, {passwordDialog->m_userNameLineEdit->text(),
+                            passwordDialog->m_passwordLineEdit->text()});
+                });
+        return dialog;
+      },
+      [this](bool accepted) {
+        if (accepted)
+          triggerPageAction(QWebEnginePage::Reload);
+      });
 }
 
-void WebView::handleAuthenticationRequired(const QUrl &requestUrl,
-                                           QAuthenticator *auth) {
+void WebView::askForCredentialsNow(const QString &introMessage,
+                                   QAuthenticator *auth) {
   QDialog dialog(window());
-  dialog.setModal(true);
+  dialog.setWindowModality(Qt::WindowModal);
   dialog.setWindowFlags(dialog.windowFlags() &
                         ~Qt::WindowContextHelpButtonHint);
-
   Ui::PasswordDialog passwordDialog;
-  passwordDialog.setupUi(&dialog);
-
-  passwordDialog.m_iconLabel->setText(QString());
-  QIcon icon(window()->style()->standardIcon(QStyle::SP_MessageBoxQuestion, 0,
-                                             window()));
-  passwordDialog.m_iconLabel->setPixmap(icon.pixmap(32, 32));
-
-  QString introMessage(
-      tr("Enter username and password for \"%1\" at %2")
-          .arg(auth->realm(), requestUrl.toString().toHtmlEscaped()));
-  passwordDialog.m_infoLabel->setText(introMessage);
-  passwordDialog.m_infoLabel->setWordWrap(true);
+  setUpPasswordDialog(&dialog, passwordDialog, introMessage);
 
   if (dialog.exec() == QDialog::Accepted) {
     auth->setUser(passwordDialog.m_userNameLineEdit->text());
@@ -274,16 +314,49 @@ void WebView::handleAuthenticationRequired(const QUrl &requestUrl,
   }
 }
 
-void WebView::handlePermissionRequested(QWebEnginePermission permission) {
-  QSettings settings(page()->profile()->persistentStoragePath() +
-                         "/settings.ini",
-                     QSettings::IniFormat);
-  settings.beginGroup("Permissions");
+bool WebView::isPageRequest(const QUrl &requestUrl) const {
+  return requestUrl == url() || requestUrl == page()->requestedUrl();
+}
+
+bool WebView::takeCredentials(const QString &key, QAuthenticator *auth) {
+  auto it = m_credentials.find(key);
+  if (it == m_credentials.end()) {
+    return false;
+  }
+  auth->setUser(it->first);
+  auth->setPassword(it->second);
+  // Used once, so wrong credentials are asked for again
+  m_credentials.erase(it);
+  return true;
+}
 
-  // Create a unique key for this domain and permission type
-  QString host = permission.origin().host().replace(".", "_");
+void WebView::handleAuthenticationRequired(const QUrl &requestUrl,
+                                           QAuthenticator *auth) {
+  const QString realm = auth->realm();
+  const QString key = "authentication\n" +
+                      PermissionStore::originKey(requestUrl) + '\n' + realm;
+  if (takeCredentials(key, auth)) {
+    return;
+  }
+
+  const QString introMessage =
+      tr("Enter username and password for \"%1\" at %2")
+          .arg(realm, requestUrl.toString().toHtmlEscaped());
+  if (!isPageRequest(requestUrl)) {
+    askForCredentialsNow(introMessage, auth);
+    return;
+  }
+
+  // The request has to be answered before this returns. It fails, and the
+  // page is loaded again with the credentials once they are entered.
+  *auth = QAuthenticator();
+  askForCredentials(key, introMessage);
+}
+
+void WebView::handlePermissionRequested(QWebEnginePermission permission) {
+  PermissionStore *permissions =
+      PermissionStore::forProfile(page()->profile());
   int type = static_cast<int>(permission.permissionType());
-  QString key = QString("grants/%1/%2").arg(host).arg(type);
 
   // Log permission request for debugging
   qDebug() << "Permission requested:";
@@ -299,7 +372,8 @@ void WebView::handlePermissionRequested(QWebEnginePermission permission) {
   }
 
   // Check if we already have a saved "Yes"
-  if (settings.value(key).toBool()) {
+  if (permissions->isGranted(permission.origin(),
+                             permission.permissionType())) {
     qDebug() << "  Permission auto-granted (previously allowed)";
     permission.grant();
     return;
@@ -309,46 +383,46 @@ void WebView::handlePermissionRequested(QWebEnginePermission permission) {
   QString title = tr("Permission Request");
   QString question = questionForPermissionType(permission.permissionType())
                          .arg(permission.origin().host());
-  if (!question.isEmpty() &&
-      QMessageBox::question(window(), title, question) == QMessageBox::Yes) {
-    qDebug() << "  Permission granted by user";
-    settings.setValue(key, true);
-    settings.sync();
-    permission.grant();
-  } else {
-    qDebug() << "  Permission denied by user";
+  if (question.isEmpty()) {
     permission.deny();
+    return;
   }
+
+  const QString key =
+      QString("permission\n%1\n%2")
+          .arg(PermissionStore::originKey(permission.origin()),
+               QString::number(type));
+  m_prompts->question(key, title, question,
+                      [permission, permissions](bool accepted) mutable {
+                        if (accepted) {
+                          qDebug() << "Permission granted by user";
+                          permission.grant();
+                          permissions->grant(permission.origin(),
+                                             permission.permissionType());
+                        } else {
+                          qDebug() << "Permission denied by user";
+                          permission.deny();
+                        }
+                      });
 }
 
-void WebView::handleProxyAuthenticationRequired(const QUrl &,
+void WebView::handleProxyAuthenticationRequired(const QUrl &requestUrl,
                                                 QAuthenticator *auth,
                                                 const QString &proxyHost) {
-  QDialog dialog(window());
-  dialog.setModal(true);
-  dialog.setWindowFlags(dialog.windowFlags() &
-                        ~Qt::WindowContextHelpButtonHint);
-
-  Ui::PasswordDialog passwordDialog;
-  passwordDialog.setupUi(&dialog);
-
-  passwordDialog.m_iconLabel->setText(QString());
-  QIcon icon(window()->style()->standardIcon(QStyle::SP_MessageBoxQuestion, 0,
-                                             window()));
-  passwordDialog.m_iconLabel->setPixmap(icon.pixmap(32, 32));
-
-  QString introMessage = tr("Connect to proxy \"%1\" using:");
-  introMessage = introMessage.arg(proxyHost.toHtmlEscaped());
-  passwordDialog.m_infoLabel->setText(introMessage);
-  passwordDialog.m_infoLabel->setWordWrap(true);
+  const QString key = "proxy\n" + proxyHost;
+  if (takeCredentials(key, auth)) {
+    return;
+  }
 
-  if (dialog.exec() == QDialog::Accepted) {
-    auth->setUser(passwordDialog.m_userNameLineEdit->text());
-    auth->setPassword(passwordDialog.m_passwordLineEdit->text());
-  } else {
-    // Set authenticator null if dialog is cancelled
-    *auth = QAuthenticator();
+  const QString introMessage =
+      tr("Connect to proxy \"%1\" using:").arg(proxyHost.toHtmlEscaped());
+  if (!isPageRequest(requestUrl)) {
+    askForCredentialsNow(introMessage, auth);
+    return;
   }
+
+  *auth = QAuthenticator();
+  askForCredentials(key, introMessage);
 }
 
 void WebView::handleWebAuthUxRequested(QWebEngineWebAuthUxRequest *request) {
@@ -378,22 +452,20 @@ void WebView::onStateChanged(QWebEngineWebAuthUxRequest::WebAuthUxState state) {
 }
 
 //! [registerProtocolHandlerRequested]
-// TODO: save to QSettings
 void WebView::handleRegisterProtocolHandlerRequested(
     QWebEngineRegisterProtocolHandlerRequest request) {
-  QSettings settings(page()->profile()->persistentStoragePath() +
-                         "/settings.ini",
-                     QSettings::IniFormat);
-  settings.beginGroup("Permissions");
+  SettingsStore *settings =
+      SettingsStore::forProfile(page()->profile()->persistentStoragePath());
 
   QString host = request.origin().host();
   QString scheme = request.scheme();
 
-  QString key = QString("ProtocolHandlers/%1/%2").arg(host, scheme);
+  QString key =
+      QString("Permissions/ProtocolHandlers/%1/%2").arg(host, scheme);
 
   // Check if we already have a saved decision
-  if (settings.contains(key)) {
-    bool allowed = settings.value(key).toBool();
+  if (settings->contains(key)) {
+    bool allowed = settings->value(key).toBool();
     if (allowed) {
       request.accept();
     } else {
@@ -403,18 +475,18 @@ void WebView::handleRegisterProtocolHandlerRequested(
   }
 
   // No saved decision found: Ask the user
-  auto answer = QMessageBox::question(
-      window(), tr("Permission Request"),
-      tr("Allow %1 to open all %2 links?").arg(host).arg(scheme));
-
-  if (answer == QMessageBox::Yes) {
-    settings.setValue(key, true);
-    request.accept();
-  } else {
-    // Save 'false' so it doesn't keep pestering the user
-    settings.setValue(key, false);
-    request.reject();
-  }
+  m_prompts->question(
+      "protocolHandler\n" + key, tr("Permission Request"),
+      tr("Allow %1 to open all %2 links?").arg(host).arg(scheme),
+      [request, settings, key](bool accepted) mutable {
+        // Save 'false' too so it doesn't keep pestering the user
+        settings->setValue(key, accepted);
+        if (accepted) {
+          request.accept();
+        } else {
+          request.reject();
+        }
+      });
 }
 //! [registerProtocolHandlerRequested]
 
@@ -437,16 +509,22 @@ void WebView::handleFileSystemAccessRequested(
     Q_UNREACHABLE();
   }
 
-  auto answer =
-      QMessageBox::question(window(), tr("File system access request"),
-                            tr("Give %1 %2 access to %3?")
-                                .arg(request.origin().host())
-                                .arg(accessType)
-                                .arg(request.filePath().toString()));
-  if (answer == QMessageBox::Yes)
-    request.accept();
-  else
-    request.reject();
+  const QString key =
+      QString("fileSystemAccess\n%1\n%2\n%3")
+          .arg(PermissionStore::originKey(request.origin()),
+               QString::number(request.accessFlags().toInt()),
+               request.filePath().toString());
+  m_prompts->question(key, tr("File system access request"),
+                      tr("Give %1 %2 access to %3?")
+                          .arg(request.origin().host())
+                          .arg(accessType)
+                          .arg(request.filePath().toString()),
+                      [request](bool accepted) mutable {
+                        if (accepted)
+                          request.accept();
+                        else
+                          request.reject();
+                      });
 }
 
 void WebView::handleImageAnimationPolicyChange(
@@ -11,12 +11,16 @@
 #include <QWebEngineFileSystemAccessRequest>
 #endif
 #include <QActionGroup>
+#include <QHash>
 #include <QWebEnginePage>
 #include <QWebEnginePermission>
 #include <QWebEngineRegisterProtocolHandlerRequest>
 #include <QWebEngineSettings>
 #include <QWebEngineWebAuthUxRequest>
 
+#include <utility>
+
+class PromptQueue;
 class WebPage;
 class WebAuthDialog;
 
@@ -62,9 +66,22 @@ private slots:
 private:
   void createWebActionTrigger(QWebEnginePage *page, QWebEnginePage::WebAction);
   void onStateChanged(QWebEngineWebAuthUxRequest::WebAuthUxState state);
+  // Asks for the credentials of key and reloads the page with them. Only
+  // for the page itself, reloading it for a subresource would be wasted.
+  void askForCredentials(const QString &key, const QString &introMessage);
+  // Asks in a window-modal dialog and answers auth before returning
+  void askForCredentialsNow(const QString &introMessage,
+                            QAuthenticator *auth);
+  // Whether requestUrl is the page in the main frame, or the one loading
+  bool isPageRequest(const QUrl &requestUrl) const;
+  bool takeCredentials(const QString &key, QAuthenticator *auth);
 
 private:
   int m_loadProgress = 100;
+  PromptQueue *m_prompts;
+  // Entered for an authentication request that was turned down while the
+  // user was asked, used by the next request with the same key
+  QHash<QString, std::pair<QString, QString>> m_credentials;
   WebAuthDialog *m_authDialog = nullptr;
   QActionGroup *m_imageAnimationGroup = nullptr;
 };